@@ -95,9 +95,23 @@ namespace dxvk {
     m_buffer = m_device->GetDXVKDevice()->createBuffer(info, memoryFlags);
     m_mapped = m_buffer->slice();
 
+    // Small dynamic buffers are typically discarded many times
+    // per frame, so allocate new slices from a shared arena
+    if (pDesc->Usage == D3D11_USAGE_DYNAMIC && m_device->GetOptions()->dynamicBufferArenas) {
+      Rc<DxvkBufferArena> arena = m_device->GetDXVKDevice()->getBufferArena(memoryFlags);
+
+      if (arena->supportsBuffer(info))
+        m_buffer->setArena(arena);
+    }
+
     // For Stream Output buffers we need a counter
     if (pDesc->BindFlags & D3D11_BIND_STREAM_OUTPUT)
       m_soCounter = m_device->AllocXfbCounterSlice();
+    
+    // Default constant buffers are updated through renames,
+    // which requires us to know the full buffer contents
+    if ((pDesc->Usage == D3D11_USAGE_DEFAULT) && (pDesc->BindFlags & D3D11_BIND_CONSTANT_BUFFER))
+      m_shadowDisabled.store(!(memoryFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT));
   }
   
   
@@ -179,6 +193,26 @@ namespace dxvk {
   }
 
 
+  bool D3D11Buffer::UpdateShadowCopy(
+          VkDeviceSize                Offset,
+          VkDeviceSize                Size,
+    const void*                       pData) {
+    if (m_shadowDisabled.load())
+      return false;
+    
+    if (Offset == 0 && Size == m_desc.ByteWidth) {
+      m_shadow.resize(Size);
+      m_shadowValid = true;
+    }
+    
+    if (!m_shadowValid)
+      return false;
+    
+    std::memcpy(m_shadow.data() + Offset, pData, Size);
+    return true;
+  }
+  
+  
   BOOL D3D11Buffer::CheckFormatFeatureSupport(
           VkFormat              Format,
           VkFormatFeatureFlags  Features) const {
@@ -91,6 +91,54 @@ namespace dxvk {
     D3D10Buffer* GetD3D10Iface() {
       return &m_d3d10;
     }
+    
+    /**
+     * \brief Checks whether the shadow copy is valid
+     * 
+     * Default-usage constant buffers keep a copy of
+     * their contents in system memory as long as they
+     * are only written through \c UpdateSubresource
+     * on the immediate context.
+     * \returns \c true if the shadow copy is valid
+     */
+    bool HasShadowCopy() const {
+      return m_shadowValid && !m_shadowDisabled.load();
+    }
+    
+    /**
+     * \brief Retrieves the shadow copy
+     * \returns Pointer to the buffer contents
+     */
+    const void* GetShadowCopy() const {
+      return m_shadow.data();
+    }
+    
+    /**
+     * \brief Writes data to the shadow copy
+     * 
+     * A full update will make the shadow copy valid,
+     * partial updates require it to be valid already.
+     * Must only be called from the immediate context.
+     * \param [in] Offset Offset of the updated range
+     * \param [in] Size Size of the updated range
+     * \param [in] pData The data to write
+     * \returns \c true if the shadow copy is valid
+     */
+    bool UpdateShadowCopy(
+            VkDeviceSize                Offset,
+            VkDeviceSize                Size,
+      const void*                       pData);
+    
+    /**
+     * \brief Disables the shadow copy
+     * 
+     * Must be called whenever the buffer is written in
+     * a way that does not update the shadow copy, e.g.
+     * by a GPU copy or from a deferred context.
+     */
+    void DisableShadowCopy() {
+      m_shadowDisabled.store(true);
+    }
 
   private:
     
@@ -100,6 +148,10 @@ namespace dxvk {
     Rc<DxvkBuffer>              m_buffer;
     DxvkBufferSlice             m_soCounter;
     DxvkPhysicalBufferSlice     m_mapped;
+    
+    std::vector<char>           m_shadow;
+    bool                        m_shadowValid = false;
+    std::atomic<bool>           m_shadowDisabled = { true };
 
     D3D10Buffer                 m_d3d10;
 
@@ -46,21 +46,37 @@ namespace dxvk {
   }
   
   
+  void D3D11CommandList::TrackResourceUsage(const Rc<DxvkResource>& Resource) {
+    m_resources.push_back(Resource);
+  }
+  
+  
   void D3D11CommandList::EmitToCommandList(ID3D11CommandList* pCommandList) {
     auto cmdList = static_cast<D3D11CommandList*>(pCommandList);
     
     for (const auto& chunk : m_chunks)
       cmdList->m_chunks.push_back(chunk);
     
+    for (const auto& resource : m_resources)
+      cmdList->m_resources.push_back(resource);
+    
     MarkSubmitted();
   }
   
   
-  void D3D11CommandList::EmitToCsThread(DxvkCsThread* CsThread) {
+  uint64_t D3D11CommandList::EmitToCsThread(DxvkCsThread* CsThread) {
+    uint64_t seq = CsThread->lastSequenceNumber();
+    
     for (const auto& chunk : m_chunks)
-      CsThread->dispatchChunk(DxvkCsChunkRef(chunk));
+      seq = CsThread->dispatchChunk(DxvkCsChunkRef(chunk));
+    
+    // Resources used by the command list are only safe
+    // to map once the last chunk has been processed
+    for (const auto& resource : m_resources)
+      resource->setCsSequenceNumber(seq);
     
     MarkSubmitted();
+    return seq;
   }
   
   
@@ -26,10 +26,13 @@ namespace dxvk {
     void AddChunk(
             DxvkCsChunkRef&&    Chunk);
     
+    void TrackResourceUsage(
+      const Rc<DxvkResource>&   Resource);
+    
     void EmitToCommandList(
             ID3D11CommandList*  pCommandList);
     
-    void EmitToCsThread(
+    uint64_t EmitToCsThread(
             DxvkCsThread*       CsThread);
     
   private:
@@ -37,7 +40,8 @@ namespace dxvk {
     D3D11Device* const m_device;
     UINT         const m_contextFlags;
     
-    std::vector<DxvkCsChunkRef> m_chunks;
+    std::vector<DxvkCsChunkRef>   m_chunks;
+    std::vector<Rc<DxvkResource>> m_resources;
 
     std::atomic<bool> m_submitted = { false };
     std::atomic<bool> m_warned    = { false };
@@ -1,4 +1,5 @@
 #include <cstring>
+#include <numeric>
 
 #include "d3d11_context.h"
 #include "d3d11_device.h"
@@ -331,6 +332,8 @@ namespace dxvk {
       auto dstBuffer = static_cast<D3D11Buffer*>(pDstResource)->GetBufferSlice();
       auto srcBuffer = static_cast<D3D11Buffer*>(pSrcResource)->GetBufferSlice();
 
+      static_cast<D3D11Buffer*>(pDstResource)->DisableShadowCopy();
+
       if (CopyFlags & D3D11_COPY_DISCARD)
         DiscardBuffer(static_cast<D3D11Buffer*>(pDstResource));
       
@@ -377,6 +380,9 @@ namespace dxvk {
             cSrcSlice.length());
         }
       });
+      
+      TrackResourceSequenceNumber(pDstResource);
+      TrackResourceSequenceNumber(pSrcResource);
     } else {
       const D3D11CommonTexture* dstTextureInfo = GetCommonTexture(pDstResource);
       const D3D11CommonTexture* srcTextureInfo = GetCommonTexture(pSrcResource);
@@ -519,6 +525,10 @@ namespace dxvk {
             cExtent);
         }
       });
+      
+      TrackTextureWrite(pDstResource, DstSubresource);
+      TrackResourceSequenceNumber(pDstResource);
+      TrackResourceSequenceNumber(pSrcResource);
     }
   }
   
@@ -547,6 +557,8 @@ namespace dxvk {
       auto dstBuffer = static_cast<D3D11Buffer*>(pDstResource)->GetBufferSlice();
       auto srcBuffer = static_cast<D3D11Buffer*>(pSrcResource)->GetBufferSlice();
       
+      static_cast<D3D11Buffer*>(pDstResource)->DisableShadowCopy();
+      
       if (dstBuffer.length() != srcBuffer.length()) {
         Logger::err(str::format(
           "D3D11: CopyResource: Mismatched buffer size",
@@ -616,7 +628,15 @@ namespace dxvk {
             cExtent);
         });
       }
+      
+      const D3D11_COMMON_TEXTURE_DESC* dstDesc = GetCommonTexture(pDstResource)->Desc();
+      
+      for (uint32_t i = 0; i < dstDesc->MipLevels * dstDesc->ArraySize; i++)
+        TrackTextureWrite(pDstResource, i);
     }
+    
+    TrackResourceSequenceNumber(pDstResource);
+    TrackResourceSequenceNumber(pSrcResource);
   }
 
 
@@ -630,6 +650,8 @@ namespace dxvk {
     if (!buf || !uav)
       return;
 
+    buf->DisableShadowCopy();
+
     EmitCs([
       cDstSlice = buf->GetBufferSlice(DstAlignedByteOffset),
       cSrcSlice = uav->GetCounterSlice()
@@ -641,6 +663,8 @@ namespace dxvk {
         cSrcSlice.offset(),
         sizeof(uint32_t));
     });
+    
+    TrackResourceSequenceNumber(buf);
   }
   
   
@@ -1063,12 +1087,41 @@ namespace dxvk {
       if (size == 0)
         return;
       
-      if (((size == bufferSlice.length())
+      // Small updates, such as most constant buffer updates,
+      // are stored directly in the CS chunk. This avoids
+      // having to allocate and reference an update buffer.
+      constexpr VkDeviceSize MaxInlineDataSize = 256;
+      
+      // Constant buffers which are only ever updated through this
+      // method are renamed on every update, including partial ones,
+      // which avoids write-after-read barriers on the GPU.
+      bool immediate = GetType() == D3D11_DEVICE_CONTEXT_IMMEDIATE;
+      
+      if (!immediate)
+        bufferResource->DisableShadowCopy();
+      
+      if (immediate && bufferResource->UpdateShadowCopy(offset, size, pSrcData)) {
+        CommitShadowCopy(bufferResource);
+      } else if (((size == bufferSlice.length())
        && (bufferSlice.buffer()->memFlags() & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT))) {
         D3D11_MAPPED_SUBRESOURCE mappedSr;
         Map(pDstResource, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedSr);
         std::memcpy(mappedSr.pData, pSrcData, size);
         Unmap(pDstResource, 0);
+      } else if (size <= MaxInlineDataSize) {
+        void* data = EmitCsData([
+          cBufferSlice  = bufferSlice.subSlice(offset, size)
+        ] (DxvkContext* ctx, const void* pData) {
+          ctx->updateBuffer(
+            cBufferSlice.buffer(),
+            cBufferSlice.offset(),
+            cBufferSlice.length(),
+            pData);
+        }, size);
+        
+        std::memcpy(data, pSrcData, size);
+        
+        TrackResourceSequenceNumber(pDstResource);
       } else {
         DxvkDataSlice dataSlice = AllocUpdateBufferSlice(size);
         std::memcpy(dataSlice.ptr(), pSrcData, size);
@@ -1083,6 +1136,8 @@ namespace dxvk {
             cBufferSlice.length(),
             cDataBuffer.ptr());
         });
+        
+        TrackResourceSequenceNumber(pDstResource);
       }
     } else {
       const D3D11CommonTexture* textureInfo = GetCommonTexture(pDstResource);
@@ -1123,6 +1178,40 @@ namespace dxvk {
       const VkDeviceSize bytesPerLayer = regionExtent.height * bytesPerRow;
       const VkDeviceSize bytesTotal    = regionExtent.depth  * bytesPerLayer;
       
+      // If the command list is only going to be executed once, we
+      // can pack the data directly into staging memory and avoid
+      // copying it again on the CS thread. The buffer offset must
+      // be a multiple of both the texel size and four bytes.
+      if (m_csFlags.test(DxvkCsChunkFlag::SingleUse)
+       && formatInfo->aspectMask == VK_IMAGE_ASPECT_COLOR_BIT) {
+        void* stagingData = nullptr;
+        
+        DxvkBufferSlice stagingSlice = AllocStagingBufferSlice(bytesTotal,
+          std::lcm(formatInfo->elementSize, VkDeviceSize(16)), &stagingData);
+        
+        m_device->imagePacker()->packImageData(
+          reinterpret_cast<char*>(stagingData),
+          reinterpret_cast<const char*>(pSrcData),
+          regionExtent, formatInfo->elementSize,
+          SrcRowPitch, SrcDepthPitch);
+        
+        EmitCs([
+          cDstImage         = textureInfo->GetImage(),
+          cDstLayers        = layers,
+          cDstOffset        = offset,
+          cDstExtent        = extent,
+          cSrcSlice         = std::move(stagingSlice)
+        ] (DxvkContext* ctx) {
+          ctx->copyBufferToImage(cDstImage, cDstLayers,
+            cDstOffset, cDstExtent, cSrcSlice.buffer(),
+            cSrcSlice.offset(), VkExtent2D { 0u, 0u });
+        });
+        
+        TrackTextureWrite(pDstResource, DstSubresource);
+        TrackResourceSequenceNumber(pDstResource);
+        return;
+      }
+      
       DxvkDataSlice imageDataBuffer = AllocUpdateBufferSlice(bytesTotal);
       
       util::packImageData(
@@ -1144,6 +1233,9 @@ namespace dxvk {
           cDstOffset, cDstExtent, cSrcData.ptr(),
           cSrcBytesPerRow, cSrcBytesPerLayer);
       });
+      
+      TrackTextureWrite(pDstResource, DstSubresource);
+      TrackResourceSequenceNumber(pDstResource);
     }
   }
   
@@ -2799,19 +2891,22 @@ namespace dxvk {
       ShaderStage, DxbcBindingType::ConstantBuffer,
       D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT);
     
+    // The shader may still be compiling on a worker thread,
+    // so only wait for it once the CS thread actually needs it
     EmitCs([
       cSlotId = slotId,
       cStage  = GetShaderStage(ShaderStage),
-      cSlice  = pShaderModule           != nullptr
-             && pShaderModule->GetIcb() != nullptr
-        ? DxvkBufferSlice(pShaderModule->GetIcb())
-        : DxvkBufferSlice(),
-      cShader = pShaderModule != nullptr
-        ? pShaderModule->GetShader()
-        : nullptr
+      cModule = pShaderModule != nullptr
+        ? *pShaderModule
+        : D3D11CommonShader()
     ] (DxvkContext* ctx) {
-      ctx->bindShader        (cStage, cShader);
-      ctx->bindResourceBuffer(cSlotId, cSlice);
+      Rc<DxvkShader> shader = cModule.GetShader();
+      Rc<DxvkBuffer> icb    = cModule.GetIcb();
+      
+      ctx->bindShader        (cStage, shader);
+      ctx->bindResourceBuffer(cSlotId, icb != nullptr
+        ? DxvkBufferSlice(icb)
+        : DxvkBufferSlice());
     });
   }
 
@@ -3355,7 +3450,170 @@ namespace dxvk {
   }
   
   
+  DxvkBufferSlice D3D11DeviceContext::AllocStagingBufferSlice(
+          VkDeviceSize                      Size,
+          VkDeviceSize                      Alignment,
+          void**                            ppMapPtr) {
+    constexpr VkDeviceSize StagingBufferSize = 4 * 1024 * 1024;
+    
+    DxvkBufferCreateInfo info;
+    info.size   = StagingBufferSize;
+    info.usage  = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    info.stages = VK_PIPELINE_STAGE_TRANSFER_BIT;
+    info.access = VK_ACCESS_TRANSFER_READ_BIT;
+    
+    VkMemoryPropertyFlags memFlags
+      = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+      | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    
+    if (Size > StagingBufferSize) {
+      // Large uploads get a dedicated buffer. Nothing
+      // else references it yet, so it is safe to map.
+      info.size = Size;
+      
+      Rc<DxvkBuffer> buffer = m_device->createBuffer(info, memFlags);
+      *ppMapPtr = buffer->mapPtr(0);
+      return DxvkBufferSlice(buffer);
+    }
+    
+    if (m_stagingBuffer == nullptr)
+      m_stagingBuffer = m_device->createBuffer(info, memFlags);
+    
+    VkDeviceSize offset = ((m_stagingOffset + Alignment - 1) / Alignment) * Alignment;
+    
+    // The buffer may be renamed on the CS thread at any time, so
+    // we need to write to the physical slice that we allocated
+    // ourselves rather than the buffer's current slice.
+    if (m_stagingSlice.handle() == VK_NULL_HANDLE
+     || offset + Size > StagingBufferSize) {
+      m_stagingSlice = m_stagingBuffer->allocPhysicalSlice();
+      
+      EmitCs([
+        cBuffer       = m_stagingBuffer,
+        cPhysSlice    = m_stagingSlice
+      ] (DxvkContext* ctx) {
+        ctx->invalidateBuffer(cBuffer, cPhysSlice);
+      });
+      
+      offset = 0;
+    }
+    
+    m_stagingOffset = offset + Size;
+    
+    *ppMapPtr = m_stagingSlice.mapPtr(offset);
+    return DxvkBufferSlice(m_stagingBuffer, offset, Size);
+  }
+  
+  
+  void D3D11DeviceContext::CommitShadowCopy(
+          D3D11Buffer*                      pBuffer) {
+    const VkDeviceSize size = pBuffer->Desc()->ByteWidth;
+    
+    // If nothing has been recorded since the last update
+    // of the same buffer, the GPU cannot have seen that
+    // slice yet, so we can simply overwrite its contents.
+    if (m_cbUpdateBuffer == pBuffer
+     && m_cbUpdateCommand == m_csChunk->commandCount()) {
+      std::memcpy(pBuffer->GetMappedSlice().mapPtr(0),
+        pBuffer->GetShadowCopy(), size);
+      return;
+    }
+    
+    DxvkPhysicalBufferSlice physicalSlice = pBuffer->DiscardSlice();
+    std::memcpy(physicalSlice.mapPtr(0), pBuffer->GetShadowCopy(), size);
+    
+    EmitCs([
+      cBuffer        = pBuffer->GetBuffer(),
+      cPhysicalSlice = std::move(physicalSlice)
+    ] (DxvkContext* ctx) {
+      ctx->invalidateBuffer(cBuffer, cPhysicalSlice);
+    });
+    
+    m_cbUpdateBuffer  = pBuffer;
+    m_cbUpdateCommand = m_csChunk->commandCount();
+  }
+  
+  
+  void D3D11DeviceContext::ResetStagingBuffer() {
+    m_stagingSlice  = DxvkPhysicalBufferSlice();
+    m_stagingOffset = 0;
+  }
+  
+  
+  void D3D11DeviceContext::UpdateMappedBuffer(
+          D3D11CommonTexture*               pResource,
+          UINT                              Subresource) {
+    const Rc<DxvkImage>  mappedImage  = pResource->GetImage();
+    const Rc<DxvkBuffer> mappedBuffer = pResource->GetMappedBuffer(Subresource);
+    
+    auto formatInfo = imageFormatInfo(mappedImage->info().format);
+    auto subresource = pResource->GetSubresourceFromIndex(
+      formatInfo->aspectMask, Subresource);
+    
+    auto subresourceLayers = vk::makeSubresourceLayers(subresource);
+    auto levelExtent = mappedImage->mipLevelExtent(subresource.mipLevel);
+    
+    if (formatInfo->aspectMask == (VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT)) {
+      // The actual Vulkan image format may differ
+      // from the format requested by the application
+      EmitCs([
+        cImageBuffer  = mappedBuffer,
+        cImage        = mappedImage,
+        cSubresources = subresourceLayers,
+        cLevelExtent  = levelExtent,
+        cFormat       = GetPackedDepthStencilFormat(pResource->Desc()->Format)
+      ] (DxvkContext* ctx) {
+        ctx->copyDepthStencilImageToPackedBuffer(
+          cImageBuffer, 0, cImage, cSubresources,
+          VkOffset2D { 0, 0 },
+          VkExtent2D { cLevelExtent.width, cLevelExtent.height },
+          cFormat);
+      });
+    } else {
+      EmitCs([
+        cImageBuffer  = mappedBuffer,
+        cImage        = mappedImage,
+        cSubresources = subresourceLayers,
+        cLevelExtent  = levelExtent
+      ] (DxvkContext* ctx) {
+        ctx->copyImageToBuffer(
+          cImageBuffer, 0, VkExtent2D { 0u, 0u },
+          cImage, cSubresources, VkOffset3D { 0, 0, 0 },
+          cLevelExtent);
+      });
+    }
+  }
+  
+  
+  Rc<DxvkResource> D3D11DeviceContext::GetTrackedResource(
+          ID3D11Resource*                   pResource) {
+    D3D11_RESOURCE_DIMENSION resourceDim = D3D11_RESOURCE_DIMENSION_UNKNOWN;
+    pResource->GetType(&resourceDim);
+    
+    // Only staging resources can be mapped without being
+    // discarded while also being used by the GPU, so we
+    // do not need to track any other type of resource.
+    if (resourceDim == D3D11_RESOURCE_DIMENSION_BUFFER) {
+      auto buffer = static_cast<D3D11Buffer*>(pResource);
+      
+      if (buffer->Desc()->Usage == D3D11_USAGE_STAGING)
+        return buffer->GetMappedSlice().resource();
+    } else {
+      auto texture = GetCommonTexture(pResource);
+      
+      if (texture->Desc()->Usage == D3D11_USAGE_STAGING)
+        return texture->GetImage();
+    }
+    
+    return nullptr;
+  }
+  
+  
   DxvkCsChunkRef D3D11DeviceContext::AllocCsChunk() {
+    // Commands in the previous chunk may already be
+    // in flight, so we must not modify their data
+    m_cbUpdateBuffer = nullptr;
+    
     return m_parent->AllocCsChunk(m_csFlags);
   }
   
@@ -651,9 +651,16 @@ namespace dxvk {
     Rc<DxvkDevice>              m_device;
     Rc<DxvkDataBuffer>          m_updateBuffer;
     
+    Rc<DxvkBuffer>              m_stagingBuffer;
+    DxvkPhysicalBufferSlice     m_stagingSlice;
+    VkDeviceSize                m_stagingOffset = 0;
+    
     DxvkCsChunkFlags            m_csFlags;
     DxvkCsChunkRef              m_csChunk;
     
+    D3D11Buffer*                m_cbUpdateBuffer  = nullptr;
+    size_t                      m_cbUpdateCommand = 0;
+    
     Com<D3D11BlendState>        m_defaultBlendState;
     Com<D3D11DepthStencilState> m_defaultDepthStencilState;
     Com<D3D11RasterizerState>   m_defaultRasterizerState;
@@ -798,6 +805,67 @@ namespace dxvk {
     
     DxvkDataSlice AllocUpdateBufferSlice(size_t Size);
     
+    /**
+     * \brief Allocates host-visible staging memory
+     * 
+     * The returned slice can be written directly by the
+     * application thread and used as a transfer source
+     * on the CS thread. Only valid for command lists
+     * that are executed exactly once.
+     * \param [in] Size Number of bytes to allocate
+     * \param [in] Alignment Required slice alignment
+     * \param [out] ppMapPtr Pointer to mapped memory
+     * \returns The allocated buffer slice
+     */
+    DxvkBufferSlice AllocStagingBufferSlice(
+            VkDeviceSize                      Size,
+            VkDeviceSize                      Alignment,
+            void**                            ppMapPtr);
+    
+    /**
+     * \brief Resets the staging buffer
+     * 
+     * Forces the next staging allocation to use a new
+     * buffer slice, so that commands recorded after this
+     * call do not depend on commands recorded before.
+     */
+    void ResetStagingBuffer();
+    
+    /**
+     * \brief Uploads a buffer's shadow copy
+     * 
+     * Renames the buffer and writes the shadow copy to the
+     * new slice. If the previous command recorded by this
+     * context did the same for the same buffer, the data
+     * is written to that slice instead, so that repeated
+     * updates between draws are coalesced.
+     * \param [in] pBuffer The buffer to update
+     */
+    void CommitShadowCopy(
+            D3D11Buffer*                      pBuffer);
+    
+    /**
+     * \brief Copies image data into the mapped buffer
+     * 
+     * Records a copy of the given subresource into its
+     * mapped buffer, packing depth-stencil data if needed.
+     * \param [in] pResource The texture
+     * \param [in] Subresource Subresource index
+     */
+    void UpdateMappedBuffer(
+            D3D11CommonTexture*               pResource,
+            UINT                              Subresource);
+    
+    /**
+     * \brief Retrieves resource to track for mapping
+     * 
+     * \param [in] pResource The D3D11 resource
+     * \returns The backing resource if the resource
+     *    is a staging resource, \c nullptr otherwise
+     */
+    static Rc<DxvkResource> GetTrackedResource(
+            ID3D11Resource*                   pResource);
+    
     DxvkCsChunkRef AllocCsChunk();
     
     template<typename T>
@@ -815,6 +883,20 @@ namespace dxvk {
       }
     }
     
+    template<typename Cmd>
+    void* EmitCsData(Cmd&& command, size_t size) {
+      void* data = m_csChunk->pushData(command, size);
+      
+      if (data == nullptr) {
+        EmitCsChunk(std::move(m_csChunk));
+        
+        m_csChunk = AllocCsChunk();
+        data = m_csChunk->pushData(command, size);
+      }
+      
+      return data;
+    }
+    
     void FlushCsChunk() {
       if (m_csChunk->commandCount() != 0) {
         EmitCsChunk(std::move(m_csChunk));
@@ -824,6 +906,13 @@ namespace dxvk {
     
     virtual void EmitCsChunk(DxvkCsChunkRef&& chunk) = 0;
     
+    virtual void TrackResourceSequenceNumber(
+            ID3D11Resource*                   pResource) = 0;
+    
+    virtual void TrackTextureWrite(
+            ID3D11Resource*                   pResource,
+            UINT                              Subresource) = 0;
+    
   };
   
 }
@@ -62,6 +62,11 @@ namespace dxvk {
       *ppCommandList = m_commandList.ref();
     m_commandList = CreateCommandList();
     
+    // Each command list must rename the staging
+    // buffer before using it, since command lists
+    // may be executed in any order.
+    ResetStagingBuffer();
+    
     if (RestoreDeferredContextState)
       RestoreState();
     else
@@ -297,6 +302,32 @@ namespace dxvk {
   void D3D11DeferredContext::EmitCsChunk(DxvkCsChunkRef&& chunk) {
     m_commandList->AddChunk(std::move(chunk));
   }
+  
+  
+  void D3D11DeferredContext::TrackResourceSequenceNumber(
+          ID3D11Resource*               pResource) {
+    // Sequence numbers are assigned when
+    // the command list gets executed
+    Rc<DxvkResource> resource = GetTrackedResource(pResource);
+    
+    if (resource != nullptr)
+      m_commandList->TrackResourceUsage(resource);
+  }
+  
+  
+  void D3D11DeferredContext::TrackTextureWrite(
+          ID3D11Resource*               pResource,
+          UINT                          Subresource) {
+    // Keep the mapped buffer in sync with the image, but
+    // only the immediate context can decide whether its
+    // contents are current since the command list may
+    // never actually be executed.
+    auto texture = GetCommonTexture(pResource);
+    
+    if (texture->Desc()->Usage == D3D11_USAGE_STAGING
+     && texture->GetMapMode() == D3D11_COMMON_TEXTURE_MAP_MODE_BUFFER)
+      UpdateMappedBuffer(texture, Subresource);
+  }
 
 
   DxvkCsChunkFlags D3D11DeferredContext::GetCsChunkFlags(
@@ -98,6 +98,13 @@ namespace dxvk {
     Com<D3D11CommandList> CreateCommandList();
     
     void EmitCsChunk(DxvkCsChunkRef&& chunk);
+    
+    void TrackResourceSequenceNumber(
+            ID3D11Resource*               pResource);
+    
+    void TrackTextureWrite(
+            ID3D11Resource*               pResource,
+            UINT                          Subresource);
 
     static DxvkCsChunkFlags GetCsChunkFlags(
             D3D11Device*                  pDevice);
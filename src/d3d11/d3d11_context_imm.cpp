@@ -357,17 +357,20 @@ namespace dxvk {
 
       return S_OK;
     } else {
-      // Wait until the resource is no longer in use
-      if (MapType != D3D11_MAP_WRITE_NO_OVERWRITE) {
-        if (!WaitForResource(buffer->resource(), MapFlags))
-          return DXGI_ERROR_WAS_STILL_DRAWING;
-      }
-
       // Use map pointer from previous map operation. This
       // way we don't have to synchronize with the CS thread
       // if the map mode is D3D11_MAP_WRITE_NO_OVERWRITE.
       DxvkPhysicalBufferSlice physicalSlice = pResource->GetMappedSlice();
       
+      // Wait until the resource is no longer in use
+      if (MapType != D3D11_MAP_WRITE_NO_OVERWRITE) {
+        uint64_t sequenceNumber = GetResourceSequenceNumber(
+          physicalSlice.resource(), pResource->Desc()->Usage);
+        
+        if (!WaitForResource(physicalSlice.resource(), sequenceNumber, MapFlags))
+          return DXGI_ERROR_WAS_STILL_DRAWING;
+      }
+      
       pMappedResource->pData      = physicalSlice.mapPtr(0);
       pMappedResource->RowPitch   = pResource->Desc()->ByteWidth;
       pMappedResource->DepthPitch = pResource->Desc()->ByteWidth;
@@ -383,7 +386,6 @@ namespace dxvk {
           UINT                        MapFlags,
           D3D11_MAPPED_SUBRESOURCE*   pMappedResource) {
     const Rc<DxvkImage>  mappedImage  = pResource->GetImage();
-    const Rc<DxvkBuffer> mappedBuffer = pResource->GetMappedBuffer();
     
     if (pResource->GetMapMode() == D3D11_COMMON_TEXTURE_MAP_MODE_NONE) {
       Logger::err("D3D11: Cannot map a device-local image");
@@ -400,7 +402,10 @@ namespace dxvk {
       const VkImageType imageType = mappedImage->info().type;
       
       // Wait for the resource to become available
-      if (!WaitForResource(mappedImage, MapFlags))
+      uint64_t sequenceNumber = GetResourceSequenceNumber(
+        mappedImage, pResource->Desc()->Usage);
+      
+      if (!WaitForResource(mappedImage, sequenceNumber, MapFlags))
         return DXGI_ERROR_WAS_STILL_DRAWING;
       
       // Query the subresource's memory layout and hope that
@@ -410,47 +415,26 @@ namespace dxvk {
       pMappedResource->RowPitch   = imageType >= VK_IMAGE_TYPE_2D ? layout.rowPitch   : layout.size;
       pMappedResource->DepthPitch = imageType >= VK_IMAGE_TYPE_3D ? layout.depthPitch : layout.size;
       return S_OK;
-    } else if (formatInfo->aspectMask == (VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT)) {
-      VkExtent3D levelExtent = mappedImage->mipLevelExtent(subresource.mipLevel);
-
-      if (MapType != D3D11_MAP_READ) {
-        Logger::err(str::format("D3D11: Map type ", MapType, " not supported for depth-stencil images"));
-        return E_INVALIDARG;
-      }
-
-      // The actual Vulkan image format may differ
-      // from the format requested by the application
-      VkFormat packFormat = GetPackedDepthStencilFormat(pResource->Desc()->Format);
-      auto packFormatInfo = imageFormatInfo(packFormat);
-
-      // This is slow, but we have to dispatch a pack
-      // operation and then immediately synchronize.
-      EmitCs([
-        cImageBuffer = mappedBuffer,
-        cImage       = mappedImage,
-        cSubresource = subresource,
-        cFormat      = packFormat
-      ] (DxvkContext* ctx) {
-        auto layers = vk::makeSubresourceLayers(cSubresource);
-        auto x = cImage->mipLevelExtent(cSubresource.mipLevel);
-
-        VkOffset2D offset = { 0, 0 };
-        VkExtent2D extent = { x.width, x.height };
-
-        ctx->copyDepthStencilImageToPackedBuffer(
-          cImageBuffer, 0, cImage, layers, offset, extent, cFormat);
-      });
-
-      WaitForResource(mappedBuffer->resource(), 0);
-
-      DxvkPhysicalBufferSlice physicalSlice = mappedBuffer->slice();
-      pMappedResource->pData      = physicalSlice.mapPtr(0);
-      pMappedResource->RowPitch   = packFormatInfo->elementSize * levelExtent.width;
-      pMappedResource->DepthPitch = packFormatInfo->elementSize * levelExtent.width * levelExtent.height;
-      return S_OK;
     } else {
+      const Rc<DxvkBuffer> mappedBuffer = pResource->GetMappedBuffer(Subresource);
+      
       VkExtent3D levelExtent = mappedImage->mipLevelExtent(subresource.mipLevel);
-      VkExtent3D blockCount = util::computeBlockCount(levelExtent, formatInfo->blockSize);
+      
+      // Depth-stencil data is packed into the buffer using the
+      // format requested by the application, which may differ
+      // from the actual Vulkan image format
+      const DxvkFormatInfo* packFormatInfo = formatInfo;
+      
+      if (formatInfo->aspectMask == (VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT)) {
+        if (MapType != D3D11_MAP_READ) {
+          Logger::err(str::format("D3D11: Map type ", MapType, " not supported for depth-stencil images"));
+          return E_INVALIDARG;
+        }
+        
+        packFormatInfo = imageFormatInfo(GetPackedDepthStencilFormat(pResource->Desc()->Format));
+      }
+      
+      VkExtent3D blockCount = util::computeBlockCount(levelExtent, packFormatInfo->blockSize);
       
       DxvkPhysicalBufferSlice physicalSlice;
       
@@ -468,33 +452,22 @@ namespace dxvk {
       } else {
         // When using any map mode which requires the image contents
         // to be preserved, and if the GPU has write access to the
-        // image, copy the current image contents into the buffer.
-        const bool copyExistingData = pResource->Desc()->Usage == D3D11_USAGE_STAGING;
-        
-        if (copyExistingData) {
-          auto subresourceLayers = vk::makeSubresourceLayers(subresource);
-          
-          EmitCs([
-            cImageBuffer  = mappedBuffer,
-            cImage        = mappedImage,
-            cSubresources = subresourceLayers,
-            cLevelExtent  = levelExtent
-          ] (DxvkContext* ctx) {
-            ctx->copyImageToBuffer(
-              cImageBuffer, 0, VkExtent2D { 0u, 0u },
-              cImage, cSubresources, VkOffset3D { 0, 0, 0 },
-              cLevelExtent);
-          });
+        // image, the buffer must hold the current image contents.
+        if (pResource->Desc()->Usage == D3D11_USAGE_STAGING) {
+          if (!WaitForReadback(pResource, Subresource, MapFlags))
+            return DXGI_ERROR_WAS_STILL_DRAWING;
+        } else {
+          SynchronizeCsThread();
+          WaitForResource(mappedBuffer->resource(), 0, 0);
         }
         
-        WaitForResource(mappedBuffer->resource(), 0);
         physicalSlice = mappedBuffer->slice();
       }
       
       // Set up map pointer. Data is tightly packed within the mapped buffer.
       pMappedResource->pData      = physicalSlice.mapPtr(0);
-      pMappedResource->RowPitch   = formatInfo->elementSize * blockCount.width;
-      pMappedResource->DepthPitch = formatInfo->elementSize * blockCount.width * blockCount.height;
+      pMappedResource->RowPitch   = packFormatInfo->elementSize * blockCount.width;
+      pMappedResource->DepthPitch = packFormatInfo->elementSize * blockCount.width * blockCount.height;
       return S_OK;
     }
   }
@@ -510,7 +483,7 @@ namespace dxvk {
       // Now that data has been written into the buffer,
       // we need to copy its contents into the image
       const Rc<DxvkImage>  mappedImage  = pResource->GetImage();
-      const Rc<DxvkBuffer> mappedBuffer = pResource->GetMappedBuffer();
+      const Rc<DxvkBuffer> mappedBuffer = pResource->GetMappedBuffer(Subresource);
       
       VkImageSubresource subresource = pResource->GetMappedSubresource();
       
@@ -538,12 +511,60 @@ namespace dxvk {
   }
   
   
-  void D3D11ImmediateContext::SynchronizeCsThread() {
+  bool D3D11ImmediateContext::WaitForReadback(
+          D3D11CommonTexture*               pResource,
+          UINT                              Subresource,
+          UINT                              MapFlags) {
+    const Rc<DxvkBuffer> mappedBuffer = pResource->GetMappedBuffer(Subresource);
+    
+    auto t0 = std::chrono::high_resolution_clock::now();
+    
+    // Copies into staging images also update the mapped buffer,
+    // so in most cases the data is already there or in flight.
+    // Otherwise, we have to copy the image contents now.
+    bool stalled = !pResource->HasReadbackData(Subresource);
+    
+    if (stalled) {
+      UpdateMappedBuffer(pResource, Subresource);
+      pResource->SetReadbackData(Subresource);
+      SynchronizeCsThread();
+    } else {
+      uint64_t sequenceNumber = GetResourceSequenceNumber(
+        pResource->GetImage(), D3D11_USAGE_STAGING);
+      
+      if (sequenceNumber != 0)
+        SynchronizeCsThread(sequenceNumber);
+    }
+    
+    // The buffer's current backing resource can
+    // only be queried after the copy has executed
+    Rc<DxvkResource> resource = mappedBuffer->resource();
+    stalled |= resource->isInUse();
+    
+    if (!WaitForResource(resource, 0, MapFlags))
+      return false;
+    
+    if (stalled) {
+      auto t1 = std::chrono::high_resolution_clock::now();
+      auto us = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0);
+      
+      m_device->addStatCtr(DxvkStatCounter::ReadbackStallCount, 1);
+      m_device->addStatCtr(DxvkStatCounter::ReadbackStallTime,  us.count());
+    }
+    
+    return true;
+  }
+  
+  
+  void D3D11ImmediateContext::SynchronizeCsThread(
+          uint64_t                          SequenceNumber) {
     // Dispatch current chunk so that all commands
-    // recorded prior to this function will be run
-    FlushCsChunk();
+    // recorded prior to this function will be run,
+    // unless we only need to wait for older chunks
+    if (SequenceNumber > m_csThread.lastSequenceNumber())
+      FlushCsChunk();
     
-    m_csThread.synchronize();
+    m_csThread.synchronize(SequenceNumber);
   }
   
   
@@ -554,16 +575,19 @@ namespace dxvk {
   
   bool D3D11ImmediateContext::WaitForResource(
     const Rc<DxvkResource>&                 Resource,
+          uint64_t                          SequenceNumber,
           UINT                              MapFlags) {
     // Some games (e.g. The Witcher 3) do not work correctly
     // when a map fails with D3D11_MAP_FLAG_DO_NOT_WAIT set
     if (!m_parent->GetOptions()->allowMapFlagNoWait)
       MapFlags &= ~D3D11_MAP_FLAG_DO_NOT_WAIT;
     
-    // Wait for the any pending D3D11 command to be executed
-    // on the CS thread so that we can determine whether the
-    // resource is currently in use or not.
-    SynchronizeCsThread();
+    // Wait for the last D3D11 command that uses the resource
+    // to be executed on the CS thread so that we can determine
+    // whether the resource is currently in use or not. If the
+    // resource was never used by the CS thread, skip the wait.
+    if (SequenceNumber != 0)
+      SynchronizeCsThread(SequenceNumber);
     
     if (Resource->isInUse()) {
       if (MapFlags & D3D11_MAP_FLAG_DO_NOT_WAIT) {
@@ -576,10 +600,8 @@ namespace dxvk {
         // Make sure pending commands using the resource get
         // executed on the the GPU if we have to wait for it
         Flush();
-        SynchronizeCsThread();
         
-        while (Resource->isInUse())
-          dxvk::this_thread::yield();
+        m_device->waitForResource(Resource);
       }
     }
     
@@ -591,6 +613,45 @@ namespace dxvk {
     m_csThread.dispatchChunk(std::move(chunk));
     m_csIsBusy = true;
   }
+  
+  
+  void D3D11ImmediateContext::TrackResourceSequenceNumber(
+          ID3D11Resource*                   pResource) {
+    // Commands are always recorded into the current chunk,
+    // which will be the next one to get dispatched
+    Rc<DxvkResource> resource = GetTrackedResource(pResource);
+    
+    if (resource != nullptr)
+      resource->setCsSequenceNumber(m_csThread.lastSequenceNumber() + 1);
+  }
+  
+  
+  void D3D11ImmediateContext::TrackTextureWrite(
+          ID3D11Resource*                   pResource,
+          UINT                              Subresource) {
+    // Read back staging images as soon as they get written
+    // so that mapping them later does not have to wait for
+    // a copy that only gets recorded at map time.
+    auto texture = GetCommonTexture(pResource);
+    
+    if (texture->Desc()->Usage == D3D11_USAGE_STAGING
+     && texture->GetMapMode() == D3D11_COMMON_TEXTURE_MAP_MODE_BUFFER) {
+      UpdateMappedBuffer(texture, Subresource);
+      texture->SetReadbackData(Subresource);
+    }
+  }
+  
+  
+  uint64_t D3D11ImmediateContext::GetResourceSequenceNumber(
+    const Rc<DxvkResource>&                 Resource,
+          D3D11_USAGE                       Usage) {
+    // Only staging resources are tracked, all other
+    // resources may be used by any command, so we
+    // have to synchronize with the CS thread fully
+    return Usage == D3D11_USAGE_STAGING
+      ? Resource->getCsSequenceNumber()
+      : DxvkCsThread::SynchronizeAll;
+  }
 
 
   void D3D11ImmediateContext::FlushImplicit(BOOL StrongHint) {
@@ -121,7 +121,8 @@ namespace dxvk {
             ID3D11UnorderedAccessView* const* ppUnorderedAccessViews,
       const UINT*                             pUAVInitialCounts);
     
-    void SynchronizeCsThread();
+    void SynchronizeCsThread(
+            uint64_t                          SequenceNumber = DxvkCsThread::SynchronizeAll);
     
   private:
     
@@ -150,11 +151,28 @@ namespace dxvk {
     
     void SynchronizeDevice();
     
+    bool WaitForReadback(
+            D3D11CommonTexture*               pResource,
+            UINT                              Subresource,
+            UINT                              MapFlags);
+    
     bool WaitForResource(
       const Rc<DxvkResource>&                 Resource,
+            uint64_t                          SequenceNumber,
             UINT                              MapFlags);
     
     void EmitCsChunk(DxvkCsChunkRef&& chunk);
+    
+    void TrackResourceSequenceNumber(
+            ID3D11Resource*                   pResource);
+    
+    void TrackTextureWrite(
+            ID3D11Resource*                   pResource,
+            UINT                              Subresource);
+    
+    uint64_t GetResourceSequenceNumber(
+      const Rc<DxvkResource>&                 Resource,
+            D3D11_USAGE                       Usage);
 
     void FlushImplicit(BOOL StrongHint);
     
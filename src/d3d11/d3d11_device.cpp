@@ -118,6 +118,8 @@ namespace dxvk {
 
     m_uavCounters = CreateUAVCounterBuffer();
     m_xfbCounters = CreateXFBCounterBuffer();
+    
+    ProbeLinearImageSupport();
   }
   
   
@@ -1720,6 +1722,54 @@ namespace dxvk {
   }
   
   
+  void D3D11Device::ProbeLinearImageSupport() {
+    // Directly mapped images are read by the GPU, so we only
+    // want to use them for dynamic textures if they can be
+    // allocated from memory that is local to the device.
+    const VkMemoryPropertyFlags dynamicMemoryFlags
+      = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+      | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+      | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    
+    if (m_d3d11Options.directDynamicTextures) {
+      if (m_dxvkAdapter->checkMemoryTypeSupport(dynamicMemoryFlags))
+        m_dynamicImageMemoryFlags = dynamicMemoryFlags;
+      else
+        Logger::info("D3D11: No device-local host-visible memory, not mapping dynamic textures directly");
+    }
+    
+    // Images must at least support transfer operations
+    // with linear tiling in order to be mapped directly
+    const VkFormatFeatureFlags requiredFeatures
+      = VK_FORMAT_FEATURE_TRANSFER_SRC_BIT_KHR
+      | VK_FORMAT_FEATURE_TRANSFER_DST_BIT_KHR;
+    
+    for (uint32_t i = 0; i < m_linearFormatFeatures.size(); i++) {
+      DXGI_FORMAT format = DXGI_FORMAT(i);
+      
+      VkFormat vkFormat = LookupFormat(format, DXGI_VK_FORMAT_MODE_ANY).Format;
+      VkFormatFeatureFlags features = 0;
+      
+      if (vkFormat != VK_FORMAT_UNDEFINED)
+        features = m_dxvkAdapter->formatProperties(vkFormat).linearTilingFeatures;
+      
+      if ((features & requiredFeatures) != requiredFeatures)
+        features = 0;
+      
+      m_linearFormatFeatures[i] = features;
+      
+      if (vkFormat != VK_FORMAT_UNDEFINED) {
+        const bool dynamicDirect = features && m_dynamicImageMemoryFlags
+          && (features & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT);
+        
+        Logger::debug(str::format("D3D11: ", format, ":",
+          "\n  Staging: ", features ? "direct" : "buffer",
+          "\n  Dynamic: ", dynamicDirect ? "direct" : "buffer"));
+      }
+    }
+  }
+  
+  
   D3D_FEATURE_LEVEL D3D11Device::GetMaxFeatureLevel(const Rc<DxvkAdapter>& Adapter) {
     static const std::array<std::pair<std::string, D3D_FEATURE_LEVEL>, 7> s_featureLevels = {{
       { "11_1", D3D_FEATURE_LEVEL_11_1 },
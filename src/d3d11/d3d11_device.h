@@ -341,6 +341,30 @@ namespace dxvk {
     const D3D11Options* GetOptions() const {
       return &m_d3d11Options;
     }
+    
+    /**
+     * \brief Linear tiling features of a format
+     * 
+     * Queried once at device creation in order to
+     * determine which textures can be mapped directly.
+     * \param [in] Format The DXGI format
+     * \returns Linear tiling format features
+     */
+    VkFormatFeatureFlags GetLinearFormatFeatures(DXGI_FORMAT Format) const {
+      return uint32_t(Format) < m_linearFormatFeatures.size()
+        ? m_linearFormatFeatures[Format]
+        : 0;
+    }
+    
+    /**
+     * \brief Memory type for directly mapped dynamic images
+     * 
+     * \returns Memory property flags, or \c 0 if dynamic
+     *    images should not be mapped directly
+     */
+    VkMemoryPropertyFlags GetDynamicImageMemoryFlags() const {
+      return m_dynamicImageMemoryFlags;
+    }
 
     D3D10Device* GetD3D10Interface() const {
       return m_d3d10Device;
@@ -383,6 +407,10 @@ namespace dxvk {
     Rc<D3D11CounterBuffer>          m_uavCounters;
     Rc<D3D11CounterBuffer>          m_xfbCounters;
     
+    std::array<VkFormatFeatureFlags,
+      DXGI_FORMAT_B4G4R4A4_UNORM + 1> m_linearFormatFeatures;
+    VkMemoryPropertyFlags           m_dynamicImageMemoryFlags = 0;
+    
     D3D11StateObjectSet<D3D11BlendState>        m_bsStateObjects;
     D3D11StateObjectSet<D3D11DepthStencilState> m_dsStateObjects;
     D3D11StateObjectSet<D3D11RasterizerState>   m_rsStateObjects;
@@ -409,6 +437,8 @@ namespace dxvk {
             VkFormat    Format,
             VkImageType Type) const;
     
+    void ProbeLinearImageSupport();
+    
     static D3D_FEATURE_LEVEL GetMaxFeatureLevel(
       const Rc<DxvkAdapter>&        Adapter);
     
@@ -1,4 +1,5 @@
 #include <cstring>
+#include <numeric>
 
 #include "d3d11_initializer.h"
 
@@ -9,6 +10,9 @@ namespace dxvk {
   : m_device(Device), m_context(m_device->createContext()) {
     m_context->beginRecording(
       m_device->createCommandList());
+    
+    if (m_device->hasTransferQueue())
+      m_transfer = new DxvkTransferContext(m_device.ptr());
   }
 
   
@@ -18,7 +22,7 @@ namespace dxvk {
 
 
   void D3D11Initializer::Flush() {
-    std::lock_guard<std::mutex> lock(m_mutex);
+    auto lock = LockContext();
 
     if (m_transferCommands != 0)
       FlushInternal();
@@ -49,30 +53,55 @@ namespace dxvk {
   void D3D11Initializer::InitDeviceLocalBuffer(
           D3D11Buffer*                pBuffer,
     const D3D11_SUBRESOURCE_DATA*     pInitialData) {
-    std::lock_guard<std::mutex> lock(m_mutex);
-
     DxvkBufferSlice bufferSlice = pBuffer->GetBufferSlice();
 
     if (pInitialData != nullptr && pInitialData->pSysMem != nullptr) {
-      m_transferMemory   += bufferSlice.length();
-      m_transferCommands += 1;
-      
-      m_context->updateBuffer(
-        bufferSlice.buffer(),
-        bufferSlice.offset(),
-        bufferSlice.length(),
-        pInitialData->pSysMem);
+      if (m_transfer != nullptr) {
+        auto lock = LockContext();
+
+        m_transferMemory   += bufferSlice.length();
+        m_transferCommands += 1;
+        
+        m_transfer->uploadBuffer(
+          bufferSlice.buffer(),
+          bufferSlice.offset(),
+          bufferSlice.length(),
+          pInitialData->pSysMem);
+        
+        FlushImplicit();
+      } else {
+        // Copy the data without holding the lock so
+        // that other threads can record their commands
+        DxvkBufferSlice stagingSlice = AllocStagingSlice(bufferSlice.length(), 16);
+        std::memcpy(stagingSlice.mapPtr(0), pInitialData->pSysMem, bufferSlice.length());
+
+        auto lock = LockContext();
+
+        m_transferMemory   += bufferSlice.length();
+        m_transferCommands += 1;
+        
+        m_context->copyBuffer(
+          bufferSlice.buffer(),
+          bufferSlice.offset(),
+          stagingSlice.buffer(),
+          stagingSlice.offset(),
+          bufferSlice.length());
+        
+        FlushImplicit();
+      }
     } else {
+      BufferClear clear;
+      clear.buffer = bufferSlice.buffer();
+      clear.slice  = bufferSlice.buffer()->subSlice(
+        bufferSlice.offset(), align(bufferSlice.length(), 4));
+
+      auto lock = LockContext();
+
       m_transferCommands += 1;
+      m_bufferClears.push_back(std::move(clear));
 
-      m_context->clearBuffer(
-        bufferSlice.buffer(),
-        bufferSlice.offset(),
-        bufferSlice.length(),
-        0u);
+      FlushImplicit();
     }
-
-    FlushImplicit();
   }
 
 
@@ -100,37 +129,136 @@ namespace dxvk {
   void D3D11Initializer::InitDeviceLocalTexture(
           D3D11CommonTexture*         pTexture,
     const D3D11_SUBRESOURCE_DATA*     pInitialData) {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    
     Rc<DxvkImage> image = pTexture->GetImage();
 
     auto formatInfo = imageFormatInfo(image->info().format);
 
-    if (pInitialData != nullptr && pInitialData->pSysMem != nullptr) {
-      // pInitialData is an array that stores an entry for
-      // every single subresource. Since we will define all
-      // subresources, this counts as initialization.
-      VkImageSubresourceLayers subresourceLayers;
-      subresourceLayers.aspectMask     = formatInfo->aspectMask;
-      subresourceLayers.mipLevel       = 0;
-      subresourceLayers.baseArrayLayer = 0;
-      subresourceLayers.layerCount     = 1;
-      
+    if (pInitialData == nullptr || pInitialData->pSysMem == nullptr) {
+      // While the Microsoft docs state that resource contents are
+      // undefined if no initial data is provided, some applications
+      // expect a resource to be pre-cleared. The clear itself is
+      // recorded when the context gets flushed.
+      auto lock = LockContext();
+
+      m_transferCommands += 1;
+      m_imageClears.push_back(image);
+
+      FlushImplicit();
+      return;
+    }
+
+    // Depth-stencil images cannot be written on a transfer
+    // queue on all implementations, so we only use it for
+    // color images and let the main context handle the rest
+    bool useTransferQueue = m_transfer != nullptr
+      && formatInfo->aspectMask == VK_IMAGE_ASPECT_COLOR_BIT;
+
+    // Color images on the main context can be packed into a
+    // staging buffer before taking the lock. Depth-stencil
+    // images keep using the regular upload path.
+    bool useStagingBuffer = m_transfer == nullptr
+      && formatInfo->aspectMask == VK_IMAGE_ASPECT_COLOR_BIT;
+
+    // pInitialData is an array that stores an entry for
+    // every single subresource. Since we will define all
+    // subresources, this counts as initialization.
+    VkImageSubresourceLayers subresourceLayers;
+    subresourceLayers.aspectMask     = formatInfo->aspectMask;
+    subresourceLayers.mipLevel       = 0;
+    subresourceLayers.baseArrayLayer = 0;
+    subresourceLayers.layerCount     = 1;
+
+    if (useStagingBuffer) {
+      // Buffer offsets must be a multiple of both the texel
+      // size and four bytes, so we cannot use align() here
+      VkDeviceSize alignment = std::lcm(formatInfo->elementSize, VkDeviceSize(16));
+      VkDeviceSize totalSize = 0;
+
+      auto getSubresourceSize = [&] (uint32_t level) {
+        VkExtent3D blockCount = util::computeBlockCount(
+          image->mipLevelExtent(level), formatInfo->blockSize);
+
+        VkDeviceSize size = formatInfo->elementSize * util::flattenImageExtent(blockCount);
+        return ((size + alignment - 1) / alignment) * alignment;
+      };
+
+      for (uint32_t level = 0; level < image->info().mipLevels; level++)
+        totalSize += getSubresourceSize(level) * image->info().numLayers;
+
+      DxvkBufferSlice stagingSlice = AllocStagingSlice(totalSize, alignment);
+      VkDeviceSize stagingOffset = 0;
+
+      std::vector<VkDeviceSize> offsets;
+      offsets.reserve(image->info().numLayers * image->info().mipLevels);
+
       for (uint32_t layer = 0; layer < image->info().numLayers; layer++) {
         for (uint32_t level = 0; level < image->info().mipLevels; level++) {
-          subresourceLayers.baseArrayLayer = layer;
-          subresourceLayers.mipLevel       = level;
-          
           const uint32_t id = D3D11CalcSubresource(
             level, layer, image->info().mipLevels);
-          
-          VkOffset3D mipLevelOffset = { 0, 0, 0 };
-          VkExtent3D mipLevelExtent = image->mipLevelExtent(level);
-
-          m_transferCommands += 1;
-          m_transferMemory   += util::computeImageDataSize(
-            image->info().format, mipLevelExtent);
-          
+
+          VkExtent3D blockCount = util::computeBlockCount(
+            image->mipLevelExtent(level), formatInfo->blockSize);
+
+          m_device->imagePacker()->packImageData(
+            reinterpret_cast<char*>(stagingSlice.mapPtr(stagingOffset)),
+            reinterpret_cast<const char*>(pInitialData[id].pSysMem),
+            blockCount, formatInfo->elementSize,
+            pInitialData[id].SysMemPitch,
+            pInitialData[id].SysMemSlicePitch);
+
+          offsets.push_back(stagingOffset);
+          stagingOffset += getSubresourceSize(level);
+        }
+      }
+
+      auto lock = LockContext();
+
+      for (uint32_t layer = 0; layer < image->info().numLayers; layer++) {
+        for (uint32_t level = 0; level < image->info().mipLevels; level++) {
+          subresourceLayers.baseArrayLayer = layer;
+          subresourceLayers.mipLevel       = level;
+
+          m_context->copyBufferToImage(
+            image, subresourceLayers,
+            VkOffset3D { 0, 0, 0 },
+            image->mipLevelExtent(level),
+            stagingSlice.buffer(),
+            stagingSlice.offset() + offsets[layer * image->info().mipLevels + level],
+            VkExtent2D { 0u, 0u });
+        }
+      }
+
+      m_transferCommands += offsets.size();
+      m_transferMemory   += totalSize;
+
+      FlushImplicit();
+      return;
+    }
+
+    auto lock = LockContext();
+
+    for (uint32_t layer = 0; layer < image->info().numLayers; layer++) {
+      for (uint32_t level = 0; level < image->info().mipLevels; level++) {
+        subresourceLayers.baseArrayLayer = layer;
+        subresourceLayers.mipLevel       = level;
+        
+        const uint32_t id = D3D11CalcSubresource(
+          level, layer, image->info().mipLevels);
+        
+        VkOffset3D mipLevelOffset = { 0, 0, 0 };
+        VkExtent3D mipLevelExtent = image->mipLevelExtent(level);
+
+        m_transferCommands += 1;
+        m_transferMemory   += util::computeImageDataSize(
+          image->info().format, mipLevelExtent);
+        
+        if (useTransferQueue) {
+          m_transfer->uploadImage(
+            image, subresourceLayers,
+            pInitialData[id].pSysMem,
+            pInitialData[id].SysMemPitch,
+            pInitialData[id].SysMemSlicePitch);
+        } else {
           m_context->updateImage(
             image, subresourceLayers,
             mipLevelOffset,
@@ -140,37 +268,6 @@ namespace dxvk {
             pInitialData[id].SysMemSlicePitch);
         }
       }
-    } else {
-      m_transferCommands += 1;
-      
-      // While the Microsoft docs state that resource contents are
-      // undefined if no initial data is provided, some applications
-      // expect a resource to be pre-cleared. We can only do that
-      // for non-compressed images, but that should be fine.
-      VkImageSubresourceRange subresources;
-      subresources.aspectMask     = formatInfo->aspectMask;
-      subresources.baseMipLevel   = 0;
-      subresources.levelCount     = image->info().mipLevels;
-      subresources.baseArrayLayer = 0;
-      subresources.layerCount     = image->info().numLayers;
-
-      if (formatInfo->flags.test(DxvkFormatFlag::BlockCompressed)) {
-        m_context->clearCompressedColorImage(image, subresources);
-      } else {
-        if (subresources.aspectMask == VK_IMAGE_ASPECT_COLOR_BIT) {
-          VkClearColorValue value = { };
-
-          m_context->clearColorImage(
-            image, value, subresources);
-        } else {
-          VkClearDepthStencilValue value;
-          value.depth   = 1.0f;
-          value.stencil = 0;
-          
-          m_context->clearDepthStencilImage(
-            image, value, subresources);
-        }
-      }
     }
 
     FlushImplicit();
@@ -185,6 +282,84 @@ namespace dxvk {
   }
 
 
+  std::unique_lock<std::mutex> D3D11Initializer::LockContext() {
+    std::unique_lock<std::mutex> lock(m_mutex, std::try_to_lock);
+
+    if (!lock.owns_lock()) {
+      m_lockContention += 1;
+      lock.lock();
+    }
+
+    return lock;
+  }
+
+
+  DxvkBufferSlice D3D11Initializer::AllocStagingSlice(
+          VkDeviceSize                Size,
+          VkDeviceSize                Alignment) {
+    DxvkBufferCreateInfo info;
+    info.size   = StagingBufferSize;
+    info.usage  = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    info.stages = VK_PIPELINE_STAGE_TRANSFER_BIT;
+    info.access = VK_ACCESS_TRANSFER_READ_BIT;
+
+    VkMemoryPropertyFlags memFlags
+      = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+      | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+    if (Size > StagingBufferSize / 4) {
+      info.size = Size;
+      return DxvkBufferSlice(m_device->createBuffer(info, memFlags));
+    }
+
+    // Staging buffers are never renamed, and every slice is only
+    // written once, so the buffers only need to stay alive until
+    // the copy commands referencing them have been recorded.
+    std::lock_guard<sync::Spinlock> lock(m_stagingLock);
+
+    VkDeviceSize offset = ((m_stagingOffset + Alignment - 1) / Alignment) * Alignment;
+
+    if (m_stagingBuffer == nullptr || offset + Size > StagingBufferSize) {
+      m_stagingBuffer = m_device->createBuffer(info, memFlags);
+      offset = 0;
+    }
+
+    m_stagingOffset = offset + Size;
+    return DxvkBufferSlice(m_stagingBuffer, offset, Size);
+  }
+
+
+  void D3D11Initializer::ClearImage(
+    const Rc<DxvkImage>&              Image) {
+    auto formatInfo = imageFormatInfo(Image->info().format);
+
+    VkImageSubresourceRange subresources;
+    subresources.aspectMask     = formatInfo->aspectMask;
+    subresources.baseMipLevel   = 0;
+    subresources.levelCount     = Image->info().mipLevels;
+    subresources.baseArrayLayer = 0;
+    subresources.layerCount     = Image->info().numLayers;
+
+    if (formatInfo->flags.test(DxvkFormatFlag::BlockCompressed)) {
+      m_context->clearCompressedColorImage(Image, subresources);
+    } else {
+      if (subresources.aspectMask == VK_IMAGE_ASPECT_COLOR_BIT) {
+        VkClearColorValue value = { };
+
+        m_context->clearColorImage(
+          Image, value, subresources);
+      } else {
+        VkClearDepthStencilValue value;
+        value.depth   = 1.0f;
+        value.stencil = 0;
+        
+        m_context->clearDepthStencilImage(
+          Image, value, subresources);
+      }
+    }
+  }
+
+
   void D3D11Initializer::FlushImplicit() {
     if (m_transferCommands > MaxTransferCommands
      || m_transferMemory   > MaxTransferMemory)
@@ -193,6 +368,27 @@ namespace dxvk {
 
 
   void D3D11Initializer::FlushInternal() {
+    // Record all pending clears in one go, which also
+    // allows the context to batch the required barriers
+    for (const auto& clear : m_bufferClears)
+      m_context->clearPhysicalBuffer(clear.buffer, clear.slice, 0u);
+
+    for (const auto& image : m_imageClears)
+      ClearImage(image);
+
+    Logger::debug(str::format(
+      "D3D11Initializer: Flushing ", m_transferCommands, " commands",
+      "\n  Memory:           ", m_transferMemory >> 10, " kB",
+      "\n  Buffer clears:    ", m_bufferClears.size(),
+      "\n  Image clears:     ", m_imageClears.size(),
+      "\n  Lock contentions: ", m_lockContention.exchange(0)));
+
+    m_bufferClears.clear();
+    m_imageClears.clear();
+
+    if (m_transfer != nullptr && m_transfer->hasPendingUploads())
+      m_transfer->flush();
+    
     m_device->submitCommandList(
       m_context->endRecording(),
       nullptr, nullptr);
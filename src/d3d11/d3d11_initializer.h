@@ -1,5 +1,7 @@
 #pragma once
 
+#include "../dxvk/dxvk_transfer.h"
+
 #include "d3d11_buffer.h"
 #include "d3d11_texture.h"
 
@@ -12,10 +14,34 @@ namespace dxvk {
    * initialization. This includes initialization
    * with application-defined data, as well as
    * zero-initialization for buffers and images.
+   * 
+   * If the device has a dedicated transfer queue,
+   * initial data uploads are recorded into a
+   * separate transfer context instead.
+   * 
+   * Otherwise, initial data for color images and
+   * buffers is packed into large staging buffers
+   * before taking the lock, and zero-initialization
+   * is deferred until the context gets flushed, so
+   * that threads creating many resources at once
+   * only hold the lock for a short amount of time.
    */
   class D3D11Initializer {
     constexpr static size_t MaxTransferMemory    = 32 * 1024 * 1024;
     constexpr static size_t MaxTransferCommands  = 512;
+    constexpr static size_t StagingBufferSize    = 16 * 1024 * 1024;
+    
+    /**
+     * \brief Pending buffer clear
+     * 
+     * Stores the physical slice that backs the buffer
+     * at creation time, since the buffer may already
+     * be renamed by the time the clear is recorded.
+     */
+    struct BufferClear {
+      Rc<DxvkBuffer>          buffer;
+      DxvkPhysicalBufferSlice slice;
+    };
   public:
 
     D3D11Initializer(
@@ -39,10 +65,26 @@ namespace dxvk {
 
     Rc<DxvkDevice>    m_device;
     Rc<DxvkContext>   m_context;
+    Rc<DxvkTransferContext> m_transfer;
 
     size_t            m_transferCommands  = 0;
     size_t            m_transferMemory    = 0;
 
+    sync::Spinlock    m_stagingLock;
+    Rc<DxvkBuffer>    m_stagingBuffer;
+    VkDeviceSize      m_stagingOffset     = 0;
+
+    std::vector<BufferClear>      m_bufferClears;
+    std::vector<Rc<DxvkImage>>    m_imageClears;
+
+    std::atomic<uint32_t> m_lockContention = { 0u };
+
+    std::unique_lock<std::mutex> LockContext();
+
+    DxvkBufferSlice AllocStagingSlice(
+            VkDeviceSize                Size,
+            VkDeviceSize                Alignment);
+
     void InitDeviceLocalBuffer(
             D3D11Buffer*                pBuffer,
       const D3D11_SUBRESOURCE_DATA*     pInitialData);
@@ -59,6 +101,9 @@ namespace dxvk {
             D3D11CommonTexture*         pTexture,
       const D3D11_SUBRESOURCE_DATA*     pInitialData);
     
+    void ClearImage(
+      const Rc<DxvkImage>&              Image);
+
     void FlushImplicit();
     void FlushInternal();
 
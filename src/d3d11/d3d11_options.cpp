@@ -9,6 +9,11 @@ namespace dxvk {
     this->dcSingleUseMode       = config.getOption<bool>("d3d11.dcSingleUseMode",       true);
     this->fakeStreamOutSupport  = config.getOption<bool>("d3d11.fakeStreamOutSupport",  false);
     this->zeroInitWorkgroupMemory = config.getOption<bool>("d3d11.zeroInitWorkgroupMemory", false);
+    this->promoteTempRegisters  = config.getOption<bool>("d3d11.promoteTempRegisters",  false);
+    this->eliminateDeadCode     = config.getOption<bool>("d3d11.eliminateDeadCode",     false);
+    this->asyncShaderCompile    = config.getOption<bool>("d3d11.asyncShaderCompile",    false);
+    this->dynamicBufferArenas   = config.getOption<bool>("d3d11.dynamicBufferArenas",   false);
+    this->directDynamicTextures = config.getOption<bool>("d3d11.directDynamicTextures", false);
     this->maxTessFactor         = config.getOption<int32_t>("d3d11.maxTessFactor",      0);
     this->samplerAnisotropy     = config.getOption<int32_t>("d3d11.samplerAnisotropy",  -1);
     this->deferSurfaceCreation  = config.getOption<bool>("dxgi.deferSurfaceCreation",   false);
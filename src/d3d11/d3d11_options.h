@@ -47,6 +47,48 @@ namespace dxvk {
     /// TGSM in compute shaders before reading it.
     bool zeroInitWorkgroupMemory;
 
+    /// Optimize temporary registers in shaders
+    ///
+    /// Runs a SPIR-V pass that turns DXBC temporary registers
+    /// into function-local variables and removes redundant
+    /// loads and stores, which reduces the module size and
+    /// may reduce pipeline compile times on some drivers.
+    bool promoteTempRegisters;
+
+    /// Remove unused code and resources from shaders
+    ///
+    /// Strips instructions, resources and inputs that are
+    /// never used from compiled shaders, so that unused
+    /// resources do not end up in the descriptor layout.
+    bool eliminateDeadCode;
+
+    /// Compile shaders on worker threads
+    ///
+    /// Shader creation returns immediately and the DXBC
+    /// shader is compiled in the background. Rendering
+    /// only waits for the shader once it is used for a
+    /// draw or dispatch. Compilation errors are logged
+    /// rather than reported to the application.
+    bool asyncShaderCompile;
+
+    /// Suballocate small dynamic buffers from shared arenas
+    ///
+    /// When enabled, discarding a small dynamic buffer
+    /// allocates the new slice from a large, device-wide
+    /// buffer instead of a buffer owned by the resource.
+    /// Reduces the number of Vulkan buffers in use for
+    /// games that frequently discard many small buffers.
+    bool dynamicBufferArenas;
+
+    /// Map dynamic textures directly
+    ///
+    /// Creates dynamic textures as linear images in device-local,
+    /// host-visible memory if supported, which saves a copy per
+    /// update. Since images cannot be renamed, discarding a texture
+    /// that is still in use by the GPU will stall, and games must
+    /// respect the row pitch returned by Map.
+    bool directDynamicTextures;
+
     /// Maximum tessellation factor.
     ///
     /// Limits tessellation factors in tessellation
@@ -8,53 +8,91 @@ namespace dxvk {
   
   
   D3D11CommonShader::D3D11CommonShader(
+    const DxvkShaderKey*  pShaderKey)
+  : m_state(new State()) {
+    m_state->name = pShaderKey->toString();
+  }
+  
+  
+  void D3D11CommonShader::Compile(
           D3D11Device*    pDevice,
     const DxvkShaderKey*  pShaderKey,
     const DxbcModuleInfo* pDxbcModuleInfo,
     const void*           pShaderBytecode,
-          size_t          BytecodeLength) {
-    const std::string name = pShaderKey->toString();
-    Logger::debug(str::format("Compiling shader ", name));
+          size_t          BytecodeLength) const {
+    // Wake up waiting threads even if compilation fails,
+    // in which case the shader will remain unbound
+    struct SignalGuard {
+      State* state;
+      ~SignalGuard() { state->Signal(); }
+    } signalGuard = { m_state.ptr() };
     
-    DxbcReader reader(
-      reinterpret_cast<const char*>(pShaderBytecode),
-      BytecodeLength);
+    const std::string& name = m_state->name;
     
-    DxbcModule module(reader);
+    Rc<DxvkShader> shader;
+    Rc<DxvkBuffer> buffer;
     
-    // If requested by the user, dump both the raw DXBC
-    // shader and the compiled SPIR-V module to a file.
-    const std::string dumpPath = env::getEnvVar("DXVK_SHADER_DUMP_PATH");
+    // Try to load the compiled shader from the disk cache.
+    // Stream output shaders are not cached since their key
+    // depends on the semantic name pointers.
+    DxvkShaderCache* shaderCache = pDxbcModuleInfo->xfb == nullptr
+      ? pDevice->GetDXVKDevice()->shaderCache()
+      : nullptr;
     
-    if (dumpPath.size() != 0) {
-      reader.store(std::ofstream(str::format(dumpPath, "/", name, ".dxbc"),
-        std::ios_base::binary | std::ios_base::trunc));
+    Sha1Hash cacheKey;
+    
+    if (shaderCache != nullptr) {
+      cacheKey = GetCacheKey(pShaderKey, pDxbcModuleInfo);
+      shader = shaderCache->lookup(cacheKey);
     }
     
-    // Decide whether we need to create a pass-through
-    // geometry shader for vertex shader stream output
-    bool passthroughShader = pDxbcModuleInfo->xfb != nullptr
-      && module.programInfo().type() != DxbcProgramType::GeometryShader;
+    if (shader == nullptr) {
+      Logger::debug(str::format("Compiling shader ", name));
+      
+      DxbcReader reader(
+        reinterpret_cast<const char*>(pShaderBytecode),
+        BytecodeLength);
+      
+      DxbcModule module(reader);
+      
+      // If requested by the user, dump both the raw DXBC
+      // shader and the compiled SPIR-V module to a file.
+      const std::string dumpPath = env::getEnvVar("DXVK_SHADER_DUMP_PATH");
+      
+      if (dumpPath.size() != 0) {
+        reader.store(std::ofstream(str::format(dumpPath, "/", name, ".dxbc"),
+          std::ios_base::binary | std::ios_base::trunc));
+      }
+      
+      // Decide whether we need to create a pass-through
+      // geometry shader for vertex shader stream output
+      bool passthroughShader = pDxbcModuleInfo->xfb != nullptr
+        && module.programInfo().type() != DxbcProgramType::GeometryShader;
 
-    m_shader = passthroughShader
-      ? module.compilePassthroughShader(*pDxbcModuleInfo, name)
-      : module.compile                 (*pDxbcModuleInfo, name);
-    m_shader->setShaderKey(*pShaderKey);
-    
-    if (dumpPath.size() != 0) {
-      std::ofstream dumpStream(
-        str::format(dumpPath, "/", name, ".spv"),
-        std::ios_base::binary | std::ios_base::trunc);
+      shader = passthroughShader
+        ? module.compilePassthroughShader(*pDxbcModuleInfo, name)
+        : module.compile                 (*pDxbcModuleInfo, name);
+      
+      if (dumpPath.size() != 0) {
+        std::ofstream dumpStream(
+          str::format(dumpPath, "/", name, ".spv"),
+          std::ios_base::binary | std::ios_base::trunc);
+        
+        shader->dump(dumpStream);
+      }
       
-      m_shader->dump(dumpStream);
+      if (shaderCache != nullptr)
+        shaderCache->add(cacheKey, shader);
     }
     
+    shader->setShaderKey(*pShaderKey);
+    
     // Create shader constant buffer if necessary
-    if (m_shader->shaderConstants().data() != nullptr) {
+    if (shader->shaderConstants().data() != nullptr) {
       DxvkBufferCreateInfo info;
-      info.size   = m_shader->shaderConstants().sizeInBytes();
+      info.size   = shader->shaderConstants().sizeInBytes();
       info.usage  = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
-      info.stages = util::pipelineStages(m_shader->stage())
+      info.stages = util::pipelineStages(shader->stage())
                   | VK_PIPELINE_STAGE_HOST_BIT;
       info.access = VK_ACCESS_UNIFORM_READ_BIT
                   | VK_ACCESS_HOST_WRITE_BIT;
@@ -64,19 +102,68 @@ namespace dxvk {
         | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
         | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
       
-      m_buffer = pDevice->GetDXVKDevice()->createBuffer(info, memFlags);
+      buffer = pDevice->GetDXVKDevice()->createBuffer(info, memFlags);
 
-      std::memcpy(m_buffer->mapPtr(0),
-        m_shader->shaderConstants().data(),
-        m_shader->shaderConstants().sizeInBytes());
+      std::memcpy(buffer->mapPtr(0),
+        shader->shaderConstants().data(),
+        shader->shaderConstants().sizeInBytes());
     }
 
-    pDevice->GetDXVKDevice()->registerShader(m_shader);
+    m_state->shader = shader;
+    m_state->buffer = buffer;
+    
+    pDevice->GetDXVKDevice()->registerShader(shader);
+  }
+  
+  
+  void D3D11CommonShader::State::Wait() {
+    if (ready.load())
+      return;
+    
+    std::unique_lock<std::mutex> lock(mutex);
+    cond.wait(lock, [this] () { return ready.load(); });
+  }
+  
+  
+  void D3D11CommonShader::State::Signal() {
+    std::lock_guard<std::mutex> lock(mutex);
+    ready.store(true);
+    cond.notify_all();
+  }
+  
+  
+  Sha1Hash D3D11CommonShader::GetCacheKey(
+    const DxvkShaderKey*  pShaderKey,
+    const DxbcModuleInfo* pDxbcModuleInfo) {
+    // The generated code depends on the shader and
+    // the compiler options, including tess factors
+    DxbcTessInfo tessInfo = { 0.0f };
+    
+    if (pDxbcModuleInfo->tess != nullptr)
+      tessInfo = *pDxbcModuleInfo->tess;
+    
+    std::array<Sha1Data, 3> chunks = {{
+      { pShaderKey,                sizeof(*pShaderKey)              },
+      { &pDxbcModuleInfo->options, sizeof(pDxbcModuleInfo->options) },
+      { &tessInfo,                 sizeof(tessInfo)                 },
+    }};
+    
+    return Sha1Hash::compute(chunks.size(), chunks.data());
   }
 
   
   D3D11ShaderModuleSet:: D3D11ShaderModuleSet() { }
-  D3D11ShaderModuleSet::~D3D11ShaderModuleSet() { }
+  
+  
+  D3D11ShaderModuleSet::~D3D11ShaderModuleSet() {
+    { std::lock_guard<std::mutex> lock(m_compilerLock);
+      m_stopThreads.store(true);
+      m_compilerCond.notify_all();
+    }
+    
+    for (auto& thread : m_compilerThreads)
+      thread.join();
+  }
   
   
   D3D11CommonShader D3D11ShaderModuleSet::GetShaderModule(
@@ -93,9 +180,42 @@ namespace dxvk {
         return entry->second;
     }
     
+    // Hand the shader off to the worker threads if possible. The
+    // module is added to the lookup table right away so that the
+    // same shader does not get compiled twice. Stream output
+    // shaders are always compiled synchronously since the xfb
+    // info references memory owned by the caller.
+    D3D11CommonShader module(pShaderKey);
+    
+    if (pDevice->GetOptions()->asyncShaderCompile
+     && pDxbcModuleInfo->xfb == nullptr) {
+      { std::unique_lock<std::mutex> lock(m_mutex);
+        
+        auto status = m_modules.insert({ *pShaderKey, module });
+        if (!status.second)
+          return status.first->second;
+      }
+      
+      CompileJob job;
+      job.device     = pDevice;
+      job.shaderKey  = *pShaderKey;
+      job.moduleInfo = *pDxbcModuleInfo;
+      job.tessInfo   = { 0.0f };
+      job.shader     = module;
+      
+      if (pDxbcModuleInfo->tess != nullptr)
+        job.tessInfo = *pDxbcModuleInfo->tess;
+      
+      job.bytecode.resize(BytecodeLength);
+      std::memcpy(job.bytecode.data(), pShaderBytecode, BytecodeLength);
+      
+      EnqueueCompileJob(std::move(job));
+      return module;
+    }
+    
     // This shader has not been compiled yet, so we have to create a
     // new module. This takes a while, so we won't lock the structure.
-    D3D11CommonShader module(pDevice, pShaderKey,
+    module.Compile(pDevice, pShaderKey,
       pDxbcModuleInfo, pShaderBytecode, BytecodeLength);
     
     // Insert the new module into the lookup table. If another thread
@@ -111,4 +231,64 @@ namespace dxvk {
     return module;
   }
   
+  
+  void D3D11ShaderModuleSet::EnqueueCompileJob(
+          CompileJob&&    Job) {
+    std::lock_guard<std::mutex> lock(m_compilerLock);
+    
+    // Start the worker threads on demand, so that we do
+    // not create any if asynchronous compilation is unused
+    if (m_compilerThreads.empty()) {
+      uint32_t numCpuCores = dxvk::thread::hardware_concurrency();
+      uint32_t numWorkers  = numCpuCores / 2;
+      
+      if (numWorkers < 1) numWorkers = 1;
+      if (numWorkers > 8) numWorkers = 8;
+      
+      Logger::info(str::format("D3D11: Using ", numWorkers, " shader compiler threads"));
+      
+      for (uint32_t i = 0; i < numWorkers; i++)
+        m_compilerThreads.emplace_back([this] () { CompilerFunc(); });
+    }
+    
+    m_compilerQueue.push(std::move(Job));
+    m_compilerCond.notify_one();
+  }
+  
+  
+  void D3D11ShaderModuleSet::CompilerFunc() {
+    env::setThreadName(L"dxvk-dxbc");
+    
+    while (true) {
+      CompileJob job;
+      
+      // Process all pending jobs before exiting since
+      // the device may still wait for these shaders
+      { std::unique_lock<std::mutex> lock(m_compilerLock);
+        
+        m_compilerCond.wait(lock, [this] () {
+          return m_compilerQueue.size()
+              || m_stopThreads.load();
+        });
+        
+        if (m_compilerQueue.size() == 0)
+          break;
+        
+        job = std::move(m_compilerQueue.front());
+        m_compilerQueue.pop();
+      }
+      
+      if (job.moduleInfo.tess != nullptr)
+        job.moduleInfo.tess = &job.tessInfo;
+      
+      try {
+        job.shader.Compile(job.device, &job.shaderKey,
+          &job.moduleInfo, job.bytecode.data(), job.bytecode.size());
+      } catch (const DxvkError& e) {
+        Logger::err(str::format("D3D11: Failed to compile shader ", job.shader.GetName()));
+        Logger::err(e.message());
+      }
+    }
+  }
+  
 }
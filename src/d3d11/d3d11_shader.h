@@ -1,7 +1,11 @@
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
 #include <mutex>
+#include <queue>
 #include <unordered_map>
+#include <vector>
 
 #include "../dxbc/dxbc_module.h"
 #include "../dxvk/dxvk_device.h"
@@ -10,6 +14,7 @@
 
 #include "../util/sha1/sha1_util.h"
 
+#include "../util/thread.h"
 #include "../util/util_env.h"
 
 #include "d3d11_device_child.h"
@@ -25,6 +30,11 @@ namespace dxvk {
    * Stores the compiled SPIR-V shader and the SHA-1
    * hash of the original DXBC shader, which can be
    * used to identify the shader.
+   * 
+   * All copies of a shader object share the same
+   * compiled shader. If the shader is compiled on
+   * a worker thread, \ref GetShader and \ref GetIcb
+   * will wait for compilation to finish.
    */
   class D3D11CommonShader {
     
@@ -32,29 +42,69 @@ namespace dxvk {
     
     D3D11CommonShader();
     D3D11CommonShader(
+      const DxvkShaderKey*  pShaderKey);
+    ~D3D11CommonShader();
+
+    /**
+     * \brief Compiles the shader
+     * 
+     * Must be called exactly once for each shader
+     * created with a shader key, either directly
+     * or on a worker thread. Signals any threads
+     * waiting for the shader, even on error.
+     * \param [in] pDevice The device
+     * \param [in] pShaderKey Shader key
+     * \param [in] pDxbcModuleInfo Compiler options
+     * \param [in] pShaderBytecode DXBC code
+     * \param [in] BytecodeLength Size of the DXBC code
+     */
+    void Compile(
             D3D11Device*    pDevice,
       const DxvkShaderKey*  pShaderKey,
       const DxbcModuleInfo* pDxbcModuleInfo,
       const void*           pShaderBytecode,
-            size_t          BytecodeLength);
-    ~D3D11CommonShader();
+            size_t          BytecodeLength) const;
 
     Rc<DxvkShader> GetShader() const {
-      return m_shader;
+      if (m_state == nullptr)
+        return nullptr;
+      
+      m_state->Wait();
+      return m_state->shader;
     }
 
     Rc<DxvkBuffer> GetIcb() const {
-      return m_buffer;
+      if (m_state == nullptr)
+        return nullptr;
+      
+      m_state->Wait();
+      return m_state->buffer;
     }
     
     std::string GetName() const {
-      return m_shader->debugName();
+      return m_state->name;
     }
     
   private:
     
-    Rc<DxvkShader> m_shader;
-    Rc<DxvkBuffer> m_buffer;
+    struct State : public RcObject {
+      std::string             name;
+      Rc<DxvkShader>          shader;
+      Rc<DxvkBuffer>          buffer;
+      
+      std::atomic<bool>       ready = { false };
+      std::mutex              mutex;
+      std::condition_variable cond;
+      
+      void Wait();
+      void Signal();
+    };
+    
+    Rc<State> m_state;
+    
+    static Sha1Hash GetCacheKey(
+      const DxvkShaderKey*  pShaderKey,
+      const DxbcModuleInfo* pDxbcModuleInfo);
     
   };
   
@@ -132,6 +182,10 @@ namespace dxvk {
    * times, so we should cache the resulting shader modules
    * and reuse them rather than creating new ones. This
    * class is thread-safe.
+   * 
+   * If enabled, shaders are compiled by a pool of worker
+   * threads, so that applications creating many shaders
+   * during loading do not have to wait for each of them.
    */
   class D3D11ShaderModuleSet {
     
@@ -149,6 +203,15 @@ namespace dxvk {
     
   private:
     
+    struct CompileJob {
+      D3D11Device*          device;
+      DxvkShaderKey         shaderKey;
+      DxbcModuleInfo        moduleInfo;
+      DxbcTessInfo          tessInfo;
+      std::vector<char>     bytecode;
+      D3D11CommonShader     shader;
+    };
+    
     std::mutex m_mutex;
     
     std::unordered_map<
@@ -156,6 +219,18 @@ namespace dxvk {
       D3D11CommonShader,
       DxvkHash, DxvkEq> m_modules;
     
+    std::atomic<bool>         m_stopThreads = { false };
+    
+    std::mutex                m_compilerLock;
+    std::condition_variable   m_compilerCond;
+    std::queue<CompileJob>    m_compilerQueue;
+    std::vector<dxvk::thread> m_compilerThreads;
+    
+    void EnqueueCompileJob(
+            CompileJob&&    Job);
+    
+    void CompilerFunc();
+    
   };
   
 }
@@ -195,7 +195,7 @@ namespace dxvk {
     // Wait for the sync event so that we
     // respect the maximum frame latency
     Rc<DxvkEvent> syncEvent = m_dxgiDevice->GetFrameSyncEvent();
-    syncEvent->wait();
+    m_device->waitForEvent(syncEvent);
     
     if (m_hud != nullptr)
       m_hud->update();
@@ -152,21 +152,30 @@ namespace dxvk {
         "\n  Usage:   ", std::hex, imageInfo.usage));
     }
     
-    // If necessary, create the mapped linear buffer
-    if (m_mapMode == D3D11_COMMON_TEXTURE_MAP_MODE_BUFFER)
-      m_buffer = CreateMappedBuffer();
-    
     // Create the image on a host-visible memory type
     // in case it is going to be mapped directly.
     VkMemoryPropertyFlags memoryProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
     
     if (m_mapMode == D3D11_COMMON_TEXTURE_MAP_MODE_DIRECT) {
-      memoryProperties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
-                       | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
-                       | VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+      memoryProperties = m_desc.Usage == D3D11_USAGE_DYNAMIC
+        ? m_device->GetDynamicImageMemoryFlags()
+        : VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+        | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+        | VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
     }
     
     m_image = m_device->GetDXVKDevice()->createImage(imageInfo, memoryProperties);
+    
+    // If necessary, prepare the mapped linear buffers. Using
+    // one buffer per subresource allows readbacks of different
+    // subresources to be in flight at the same time. Buffers
+    // are only created once a subresource is actually used.
+    if (m_mapMode == D3D11_COMMON_TEXTURE_MAP_MODE_BUFFER) {
+      const UINT subresourceCount = m_desc.MipLevels * m_desc.ArraySize;
+      
+      m_buffers.resize(subresourceCount);
+      m_readbackValid.resize(subresourceCount, false);
+    }
   }
   
   
@@ -369,19 +378,33 @@ namespace dxvk {
     if (m_desc.CPUAccessFlags == 0)
       return D3D11_COMMON_TEXTURE_MAP_MODE_NONE;
     
+    // Depth-stencil formats in D3D11 can be mapped and follow special
+    // packing rules, so we need to copy that data into a buffer first
+    if (GetPackedDepthStencilFormat(m_desc.Format))
+      return D3D11_COMMON_TEXTURE_MAP_MODE_BUFFER;
+    
+    // Skip formats that do not support linear tiling at all
+    VkFormatFeatureFlags linearFeatures = m_device->GetLinearFormatFeatures(m_desc.Format);
+    
+    if (!linearFeatures)
+      return D3D11_COMMON_TEXTURE_MAP_MODE_BUFFER;
+    
     // Write-only images should go through a buffer for multiple reasons:
     // 1. Some games do not respect the row and depth pitch that is returned
     //    by the Map() method, which leads to incorrect rendering (e.g. Nier)
     // 2. Since the image will most likely be read for rendering by the GPU,
     //    writing the image to device-local image may be more efficient than
     //    reading its contents from host-visible memory.
-    if (m_desc.Usage == D3D11_USAGE_DYNAMIC)
-      return D3D11_COMMON_TEXTURE_MAP_MODE_BUFFER;
-    
-    // Depth-stencil formats in D3D11 can be mapped and follow special
-    // packing rules, so we need to copy that data into a buffer first
-    if (GetPackedDepthStencilFormat(m_desc.Format))
-      return D3D11_COMMON_TEXTURE_MAP_MODE_BUFFER;
+    // The user can opt out of this if device-local, host-visible memory
+    // is available, which removes one copy for every update.
+    if (m_desc.Usage == D3D11_USAGE_DYNAMIC) {
+      if (!m_device->GetDynamicImageMemoryFlags())
+        return D3D11_COMMON_TEXTURE_MAP_MODE_BUFFER;
+      
+      if ((m_desc.BindFlags & D3D11_BIND_SHADER_RESOURCE)
+       && !(linearFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT))
+        return D3D11_COMMON_TEXTURE_MAP_MODE_BUFFER;
+    }
     
     // Images that can be read by the host should be mapped directly in
     // order to avoid expensive synchronization with the GPU. This does
@@ -393,12 +416,28 @@ namespace dxvk {
   }
   
   
-  Rc<DxvkBuffer> D3D11CommonTexture::CreateMappedBuffer() const {
+  Rc<DxvkBuffer> D3D11CommonTexture::GetMappedBuffer(UINT Subresource) {
+    if (Subresource >= m_buffers.size())
+      return nullptr;
+    
+    // Deferred contexts may request
+    // buffers from other threads
+    std::lock_guard<std::mutex> lock(m_bufferMutex);
+    
+    if (m_buffers[Subresource] == nullptr)
+      m_buffers[Subresource] = CreateMappedBuffer(Subresource % m_desc.MipLevels);
+    
+    return m_buffers[Subresource];
+  }
+  
+  
+  Rc<DxvkBuffer> D3D11CommonTexture::CreateMappedBuffer(
+          UINT                  MipLevel) const {
     const DxvkFormatInfo* formatInfo = imageFormatInfo(
       m_device->LookupFormat(m_desc.Format, GetFormatMode()).Format);
     
     const VkExtent3D blockCount = util::computeBlockCount(
-      VkExtent3D { m_desc.Width, m_desc.Height, m_desc.Depth },
+      m_image->mipLevelExtent(MipLevel),
       formatInfo->blockSize);
     
     DxvkBufferCreateInfo info;
@@ -92,10 +92,38 @@ namespace dxvk {
     
     /**
      * \brief The DXVK buffer
+     * 
+     * Textures that are mapped through a buffer
+     * use a separate buffer for each subresource,
+     * which is created on first use.
+     * \param [in] Subresource Subresource index
      * \returns The DXVK buffer
      */
-    Rc<DxvkBuffer> GetMappedBuffer() const {
-      return m_buffer;
+    Rc<DxvkBuffer> GetMappedBuffer(UINT Subresource);
+    
+    /**
+     * \brief Checks whether the mapped buffer is up to date
+     * 
+     * If this returns \c TRUE, the mapped buffer for the
+     * given subresource will hold the current contents of
+     * the image once all previously recorded commands have
+     * been executed, so no copy is needed when mapping it.
+     * Only used by the immediate context.
+     * \param [in] Subresource Subresource index
+     * \returns \c TRUE if the buffer is up to date
+     */
+    BOOL HasReadbackData(UINT Subresource) const {
+      return Subresource < m_readbackValid.size()
+        && m_readbackValid[Subresource];
+    }
+    
+    /**
+     * \brief Marks the mapped buffer as up to date
+     * \param [in] Subresource Subresource index
+     */
+    void SetReadbackData(UINT Subresource) {
+      if (Subresource < m_readbackValid.size())
+        m_readbackValid[Subresource] = true;
     }
     
     /**
@@ -191,14 +219,17 @@ namespace dxvk {
     D3D11_COMMON_TEXTURE_DESC     m_desc;
     D3D11_COMMON_TEXTURE_MAP_MODE m_mapMode;
     
-    Rc<DxvkImage>   m_image;
-    Rc<DxvkBuffer>  m_buffer;
+    Rc<DxvkImage>               m_image;
+    std::mutex                  m_bufferMutex;
+    std::vector<Rc<DxvkBuffer>> m_buffers;
+    std::vector<bool>           m_readbackValid;
     
     VkImageSubresource m_mappedSubresource
       = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0 };
     D3D11_MAP m_mapType = D3D11_MAP_READ;
     
-    Rc<DxvkBuffer> CreateMappedBuffer() const;
+    Rc<DxvkBuffer> CreateMappedBuffer(
+            UINT                  MipLevel) const;
     
     BOOL CheckImageSupport(
       const DxvkImageCreateInfo*  pImageInfo,
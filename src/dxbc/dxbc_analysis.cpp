@@ -33,6 +33,21 @@ namespace dxvk {
           const uint32_t registerId = ins.dst[operandId].idx[0].offset;
           m_analysis->uavInfos[registerId].accessAtomicOp = true;
         }
+        
+        processUavAccess(ins.dst[operandId], true, true);
+      } break;
+      
+      case DxbcInstClass::AtomicCounter: {
+        processUavAccess(ins.dst[1], false, false);
+      } break;
+      
+      case DxbcInstClass::BufferLoad: {
+        processUavAccess(ins.src[ins.srcCount - 1], true, false);
+      } break;
+      
+      case DxbcInstClass::BufferStore:
+      case DxbcInstClass::TypedUavStore: {
+        processUavAccess(ins.dst[0], false, true);
       } break;
       
       case DxbcInstClass::TextureSample:
@@ -43,11 +58,21 @@ namespace dxvk {
       case DxbcInstClass::ControlFlow: {
         if (ins.op == DxbcOpcode::Discard)
           m_analysis->usesKill = true;
+        
+        processControlFlow(ins);
+      } break;
+      
+      case DxbcInstClass::HullShaderPhase: {
+        // Each phase starts with uniform control flow
+        m_controlFlowDepth = 0;
+        m_divergent        = false;
       } break;
       
       case DxbcInstClass::TypedUavLoad: {
         const uint32_t registerId = ins.src[1].idx[0].offset;
         m_analysis->uavInfos[registerId].accessTypedLoad = true;
+        
+        processUavAccess(ins.src[1], true, false);
       } break;
       
       default:
@@ -56,6 +81,67 @@ namespace dxvk {
   }
   
   
+  void DxbcAnalyzer::processControlFlow(const DxbcShaderInstruction& ins) {
+    // We do not know which values are uniform, so any
+    // branch is assumed to diverge, and so is any code
+    // after an instruction that may end some but not
+    // all invocations, or leave a loop early.
+    switch (ins.op) {
+      case DxbcOpcode::If:
+      case DxbcOpcode::Loop:
+      case DxbcOpcode::Switch:
+        m_controlFlowDepth += 1;
+        break;
+      
+      case DxbcOpcode::EndIf:
+      case DxbcOpcode::EndLoop:
+      case DxbcOpcode::EndSwitch:
+        if (m_controlFlowDepth)
+          m_controlFlowDepth -= 1;
+        break;
+      
+      case DxbcOpcode::Retc:
+      case DxbcOpcode::Discard:
+      case DxbcOpcode::Call:
+      case DxbcOpcode::Callc:
+        // Subroutines are analyzed after the main
+        // function, so assume that they may discard
+        m_divergent = true;
+        break;
+      
+      case DxbcOpcode::Ret:
+        if (m_controlFlowDepth)
+          m_divergent = true;
+        break;
+      
+      case DxbcOpcode::Label:
+        // Subroutines may be called from anywhere
+        m_controlFlowDepth = 0;
+        m_divergent        = true;
+        break;
+      
+      default:
+        break;
+    }
+  }
+  
+  
+  void DxbcAnalyzer::processUavAccess(
+    const DxbcRegister&           reg,
+          bool                    read,
+          bool                    write) {
+    if (reg.type != DxbcOperandType::UnorderedAccessView)
+      return;
+    
+    DxbcUavInfo& info = m_analysis->uavInfos[reg.idx[0].offset];
+    info.accessRead  |= read;
+    info.accessWrite |= write;
+    
+    if (m_controlFlowDepth || m_divergent)
+      info.accessNonUniform = true;
+  }
+  
+  
   DxbcClipCullInfo DxbcAnalyzer::getClipCullInfo(const Rc<DxbcIsgn>& sgn) const {
     DxbcClipCullInfo result;
     
@@ -15,10 +15,20 @@ namespace dxvk {
    * Stores whether an UAV is accessed with typed
    * read or atomic instructions. This information
    * will be used to generate image types.
+   * 
+   * Also stores whether the UAV is read or written
+   * at all, and whether any access may happen in
+   * non-uniform control flow, i.e. inside a branch,
+   * loop or switch, or after a conditional return
+   * or discard. Counter operations are included in
+   * the latter, but do not count as reads or writes.
    */
   struct DxbcUavInfo {
-    bool accessTypedLoad = false;
-    bool accessAtomicOp  = false;
+    bool accessTypedLoad  = false;
+    bool accessAtomicOp   = false;
+    bool accessRead       = false;
+    bool accessWrite      = false;
+    bool accessNonUniform = false;
   };
   
   /**
@@ -76,6 +86,17 @@ namespace dxvk {
     
     DxbcAnalysisInfo* m_analysis = nullptr;
     
+    uint32_t m_controlFlowDepth = 0;
+    bool     m_divergent        = false;
+    
+    void processControlFlow(
+      const DxbcShaderInstruction&  ins);
+    
+    void processUavAccess(
+      const DxbcRegister&           reg,
+            bool                    read,
+            bool                    write);
+    
     DxbcClipCullInfo getClipCullInfo(
       const Rc<DxbcIsgn>& sgn) const;
     
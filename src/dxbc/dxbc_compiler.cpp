@@ -239,14 +239,31 @@ namespace dxvk {
         shaderOptions.xfbStrides[i] = m_moduleInfo.xfb->strides[i];
     }
 
+    SpirvCodeBuffer code = m_module.compile();
+
+    // Run optional optimization passes on the final module
+    SpirvPassManager passes;
+
+    if (m_moduleInfo.options.promoteTempRegisters)
+      passes.addPass(std::make_unique<SpirvPromotePrivateVarsPass>());
+
+    if (m_moduleInfo.options.eliminateDeadCode)
+      passes.addPass(std::make_unique<SpirvDeadCodePass>());
+
+    passes.run(code);
+
+    // Resources that are declared but never accessed may
+    // have been removed, so don't add them to the layout
+    if (m_moduleInfo.options.eliminateDeadCode)
+      this->pruneResourceSlots(code);
+
     // Create the shader module object
     return new DxvkShader(
       m_programInfo.shaderStage(),
       m_resourceSlots.size(),
       m_resourceSlots.data(),
       m_interfaceSlots,
-      m_module.compile(),
-      shaderOptions,
+      code, shaderOptions,
       std::move(m_immConstData));
   }
   
@@ -950,14 +967,14 @@ namespace dxvk {
     m_module.decorateDescriptorSet(varId, 0);
     m_module.decorateBinding(varId, bindingId);
     
-    if (ins.controls.uavFlags().test(DxbcUavFlag::GloballyCoherent))
-      m_module.decorate(varId, spv::DecorationCoherent);
-    
-    // On GPUs which don't support storageImageReadWithoutFormat,
-    // we have to decorate untyped UAVs as write-only
-    if (isUav && imageFormat == spv::ImageFormatUnknown
-     && !m_moduleInfo.options.useStorageImageReadWithoutFormat)
-      m_module.decorate(varId, spv::DecorationNonReadable);
+    if (isUav) {
+      // On GPUs which don't support storageImageReadWithoutFormat,
+      // we have to decorate untyped UAVs as write-only
+      bool nonReadable = imageFormat == spv::ImageFormatUnknown
+        && !m_moduleInfo.options.useStorageImageReadWithoutFormat;
+      
+      emitDclUavAccessDecorations(ins, registerId, varId, nonReadable);
+    }
     
     // Declare a specialization constant which will
     // store whether or not the resource is bound.
@@ -1023,6 +1040,29 @@ namespace dxvk {
   }
   
   
+  void DxbcCompiler::emitDclUavAccessDecorations(
+    const DxbcShaderInstruction&  ins,
+          uint32_t                regId,
+          uint32_t                varId,
+          bool                    nonReadable) {
+    const DxbcUavInfo& info = m_analysis->uavInfos[regId];
+    
+    // Coherence only matters if the shader actually
+    // accesses the UAV, which it may not always do.
+    if (ins.controls.uavFlags().test(DxbcUavFlag::GloballyCoherent)
+     && (info.accessRead || info.accessWrite))
+      m_module.decorate(varId, spv::DecorationCoherent);
+    
+    // Tell the driver if the UAV is never read or never
+    // written, so that it can optimize accesses to it
+    if (nonReadable || !info.accessRead)
+      m_module.decorate(varId, spv::DecorationNonReadable);
+    
+    if (!info.accessWrite)
+      m_module.decorate(varId, spv::DecorationNonWritable);
+  }
+  
+  
   void DxbcCompiler::emitDclResourceRawStructured(const DxbcShaderInstruction& ins) {
     // dcl_resource_raw and dcl_uav_raw take one argument:
     //    (dst0) The resource register ID
@@ -1077,8 +1117,8 @@ namespace dxvk {
     m_module.decorateDescriptorSet(varId, 0);
     m_module.decorateBinding(varId, bindingId);
     
-    if (ins.controls.uavFlags().test(DxbcUavFlag::GloballyCoherent))
-      m_module.decorate(varId, spv::DecorationCoherent);
+    if (isUav)
+      emitDclUavAccessDecorations(ins, registerId, varId, false);
     
     // Declare a specialization constant which will
     // store whether or not the resource is bound.
@@ -2158,7 +2198,7 @@ namespace dxvk {
     DxbcConditional cond;
     
     if (isUav) {
-      uint32_t writeTest = emitUavWriteTest(bufferInfo);
+      uint32_t writeTest = emitUavWriteTest(ins.dst[ins.dstCount - 1], bufferInfo);
       
       cond.labelIf  = m_module.allocateId();
       cond.labelEnd = m_module.allocateId();
@@ -2310,7 +2350,7 @@ namespace dxvk {
       m_uavs.at(registerId).ctrId = emitDclUavCounter(registerId);
     
     // Only perform the operation if the UAV is bound
-    uint32_t writeTest = emitUavWriteTest(bufferInfo);
+    uint32_t writeTest = emitUavWriteTest(ins.dst[1], bufferInfo);
     
     DxbcConditional cond;
     cond.labelIf  = m_module.allocateId();
@@ -3505,7 +3545,7 @@ namespace dxvk {
     const DxbcBufferInfo uavInfo = getBufferInfo(ins.dst[0]);
     
     // Execute write op only if the UAV is bound
-    uint32_t writeTest = emitUavWriteTest(uavInfo);
+    uint32_t writeTest = emitUavWriteTest(ins.dst[0], uavInfo);
     
     DxbcConditional cond;
     cond.labelIf  = m_module.allocateId();
@@ -4853,7 +4893,7 @@ namespace dxvk {
     DxbcConditional cond;
     
     if (isUav) {
-      uint32_t writeTest = emitUavWriteTest(bufferInfo);
+      uint32_t writeTest = emitUavWriteTest(operand, bufferInfo);
       
       cond.labelIf  = m_module.allocateId();
       cond.labelEnd = m_module.allocateId();
@@ -6052,11 +6092,18 @@ namespace dxvk {
   }
   
   
-  uint32_t DxbcCompiler::emitUavWriteTest(const DxbcBufferInfo& uav) {
+  uint32_t DxbcCompiler::emitUavWriteTest(
+    const DxbcRegister&           reg,
+    const DxbcBufferInfo&         uav) {
     uint32_t typeId = m_module.defBoolType();
     uint32_t testId = uav.specId;
     
-    if (m_ps.killState != 0) {
+    // If the UAV is only accessed in uniform control flow,
+    // no access can follow a discard, so the kill state
+    // is known to be false and we do not need to test it.
+    const DxbcUavInfo& info = m_analysis->uavInfos[reg.idx[0].offset];
+    
+    if (m_ps.killState != 0 && info.accessNonUniform) {
       uint32_t killState = m_module.opLoad(typeId, m_ps.killState);
       
       testId = m_module.opLogicalAnd(typeId, testId,
@@ -6467,6 +6514,36 @@ namespace dxvk {
   }
   
   
+  void DxbcCompiler::pruneResourceSlots(
+          SpirvCodeBuffer&        code) {
+    // Resource bindings and the specialization constants
+    // used to check whether a resource is bound both use
+    // the resource slot index, and get remapped together.
+    std::vector<bool> slotsUsed(MaxNumResourceSlots, false);
+
+    for (auto ins : code) {
+      if (ins.opCode() == spv::OpDecorate
+       && (ins.arg(2) == spv::DecorationBinding
+        || ins.arg(2) == spv::DecorationSpecId)
+       && (ins.arg(3) < MaxNumResourceSlots))
+        slotsUsed[ins.arg(3)] = true;
+    }
+
+    size_t slotCount = m_resourceSlots.size();
+
+    m_resourceSlots.erase(std::remove_if(
+      m_resourceSlots.begin(), m_resourceSlots.end(),
+      [&slotsUsed] (const DxvkResourceSlot& slot) {
+        return !slotsUsed[slot.slot];
+      }), m_resourceSlots.end());
+
+    if (m_resourceSlots.size() != slotCount) {
+      Logger::debug(str::format("DxbcCompiler: Removed ",
+        slotCount - m_resourceSlots.size(), " unused resource slots"));
+    }
+  }
+
+
   void DxbcCompiler::emitXfbOutputDeclarations() {
     for (uint32_t i = 0; i < m_moduleInfo.xfb->entryCount; i++) {
       const DxbcXfbEntry* xfbEntry = m_moduleInfo.xfb->entries + i;
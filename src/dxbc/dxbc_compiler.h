@@ -4,6 +4,8 @@
 #include <vector>
 
 #include "../spirv/spirv_module.h"
+#include "../spirv/spirv_pass_dce.h"
+#include "../spirv/spirv_pass_promote.h"
 
 #include "dxbc_analysis.h"
 #include "dxbc_chunk_isgn.h"
@@ -582,6 +584,12 @@ namespace dxvk {
     void emitDclResourceRawStructured(
       const DxbcShaderInstruction&  ins);
     
+    void emitDclUavAccessDecorations(
+      const DxbcShaderInstruction&  ins,
+            uint32_t                regId,
+            uint32_t                varId,
+            bool                    nonReadable);
+    
     void emitDclThreadGroupSharedMemory(
       const DxbcShaderInstruction&  ins);
     
@@ -1049,6 +1057,7 @@ namespace dxvk {
     ///////////////////////////////
     // Some state checking methods
     uint32_t emitUavWriteTest(
+      const DxbcRegister&           reg,
       const DxbcBufferInfo&         uav);
     
     //////////////////////////////////////
@@ -1084,6 +1093,9 @@ namespace dxvk {
     void emitPsFinalize();
     void emitCsFinalize();
 
+    void pruneResourceSlots(
+            SpirvCodeBuffer&        code);
+
     ///////////////////////
     // Xfb related methods
     void emitXfbOutputDeclarations();
@@ -38,6 +38,33 @@ namespace dxvk {
   
   
   
+  DxbcDecodeArena::DxbcDecodeArena() {
+    
+  }
+  
+  
+  DxbcDecodeArena::~DxbcDecodeArena() {
+    
+  }
+  
+  
+  void* DxbcDecodeArena::alloc(size_t size, size_t align) {
+    constexpr size_t MinBlockSize = 16384;
+    
+    size_t offset = (m_blockOffset + align - 1) & ~(align - 1);
+    
+    if (m_blocks.empty() || offset + size > m_blockSize) {
+      m_blockSize   = std::max(size, MinBlockSize);
+      m_blockOffset = 0;
+      m_blocks.emplace_back(new char[m_blockSize]);
+      offset = 0;
+    }
+    
+    m_blockOffset = offset + size;
+    return m_blocks.back().get() + offset;
+  }
+  
+  
   void DxbcDecodeContext::decodeInstruction(DxbcCodeSlice& code) {
     const uint32_t token0 = code.at(0);
     
@@ -78,6 +105,36 @@ namespace dxvk {
   }
   
   
+  DxbcShaderInstruction DxbcDecodeContext::storeInstruction(
+          DxbcDecodeArena&      arena) const {
+    DxbcShaderInstruction result = m_instruction;
+    
+    DxbcRegister* indices = arena.copy(m_indexId, m_indices.data());
+    DxbcRegister* dst     = arena.copy(result.dstCount, result.dst);
+    DxbcRegister* src     = arena.copy(result.srcCount, result.src);
+    
+    result.dst = dst;
+    result.src = src;
+    result.imm = arena.copy(result.immCount, result.imm);
+    
+    // Relative indices point into the decoder's index
+    // array, so we need to redirect them to the copy
+    auto remapIndices = [this, indices] (DxbcRegister* regs, uint32_t count) {
+      for (uint32_t i = 0; i < count; i++) {
+        for (uint32_t j = 0; j < DxbcMaxRegIndexDim; j++) {
+          if (regs[i].idx[j].relReg != nullptr)
+            regs[i].idx[j].relReg = indices + (regs[i].idx[j].relReg - m_indices.data());
+        }
+      }
+    };
+    
+    remapIndices(indices, m_indexId);
+    remapIndices(dst, result.dstCount);
+    remapIndices(src, result.srcCount);
+    return result;
+  }
+  
+  
   void DxbcDecodeContext::decodeCustomData(DxbcCodeSlice code) {
     const uint32_t blockLength = code.at(1);
     
@@ -357,4 +414,21 @@ namespace dxvk {
     }
   }
   
-}
\ No newline at end of file
+  
+  DxbcInstructionStream::DxbcInstructionStream(
+          DxbcCodeSlice         code) {
+    DxbcDecodeContext decoder;
+    
+    while (!code.atEnd()) {
+      decoder.decodeInstruction(code);
+      m_instructions.push_back(
+        decoder.storeInstruction(m_arena));
+    }
+  }
+  
+  
+  DxbcInstructionStream::~DxbcInstructionStream() {
+    
+  }
+  
+}
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <array>
+#include <memory>
+#include <vector>
 
 #include "dxbc_common.h"
 #include "dxbc_decoder.h"
@@ -365,7 +367,9 @@ namespace dxvk {
    * external structures, such as the original code
    * buffer. This is safe to use if and only if:
    * - The \ref DxbcDecodeContext that created it
-   *   still exists and was not moved
+   *   still exists and was not moved, or the
+   *   \ref DxbcInstructionStream that stores it
+   *   still exists
    * - The code buffer that was being decoded
    *   still exists and was not moved.
    */
@@ -425,6 +429,59 @@ namespace dxvk {
   };
   
   
+  /**
+   * \brief Decoder arena
+   * 
+   * Linear allocator for decoded instruction operands.
+   * Memory is allocated in large blocks, so pointers
+   * remain valid until the arena is destroyed. Only
+   * trivially destructible types can be allocated.
+   */
+  class DxbcDecodeArena {
+    
+  public:
+    
+    DxbcDecodeArena();
+    ~DxbcDecodeArena();
+    
+    DxbcDecodeArena             (const DxbcDecodeArena&) = delete;
+    DxbcDecodeArena& operator = (const DxbcDecodeArena&) = delete;
+    
+    /**
+     * \brief Copies an array of objects into the arena
+     * 
+     * \param [in] count Number of objects
+     * \param [in] data Objects to copy
+     * \returns Pointer to the copied objects
+     */
+    template<typename T>
+    T* copy(size_t count, const T* data) {
+      static_assert(std::is_trivially_destructible<T>::value);
+      
+      if (!count)
+        return nullptr;
+      
+      T* result = reinterpret_cast<T*>(
+        alloc(sizeof(T) * count, alignof(T)));
+      
+      for (size_t i = 0; i < count; i++)
+        new (&result[i]) T(data[i]);
+      
+      return result;
+    }
+    
+  private:
+    
+    std::vector<std::unique_ptr<char[]>> m_blocks;
+    
+    size_t m_blockSize   = 0;
+    size_t m_blockOffset = 0;
+    
+    void* alloc(size_t size, size_t align);
+    
+  };
+  
+  
   /**
    * \brief Decode context
    * 
@@ -455,6 +512,19 @@ namespace dxvk {
      */
     void decodeInstruction(DxbcCodeSlice& code);
     
+    /**
+     * \brief Copies the current instruction
+     * 
+     * Stores all operands of the last decoded instruction,
+     * including relative index registers, in the given
+     * arena. The returned instruction remains valid for
+     * as long as the arena and the code buffer exist.
+     * \param [in] arena Arena to allocate operands from
+     * \returns Persistent copy of the instruction
+     */
+    DxbcShaderInstruction storeInstruction(
+            DxbcDecodeArena&      arena) const;
+    
   private:
     
     DxbcShaderInstruction m_instruction;
@@ -483,4 +553,45 @@ namespace dxvk {
     
   };
   
-}
\ No newline at end of file
+  
+  /**
+   * \brief Decoded instruction stream
+   * 
+   * Decodes a shader's entire token stream once, so that
+   * multiple passes can iterate over the instructions
+   * without decoding them again. Operands are stored in
+   * an arena owned by the stream. Custom data still
+   * points into the original code buffer, which must
+   * outlive the stream.
+   */
+  class DxbcInstructionStream {
+    
+  public:
+    
+    DxbcInstructionStream(
+            DxbcCodeSlice         code);
+    
+    ~DxbcInstructionStream();
+    
+    DxbcInstructionStream             (const DxbcInstructionStream&) = delete;
+    DxbcInstructionStream& operator = (const DxbcInstructionStream&) = delete;
+    
+    /**
+     * \brief Number of instructions
+     * \returns Number of instructions
+     */
+    size_t size() const {
+      return m_instructions.size();
+    }
+    
+    auto begin() const { return m_instructions.begin(); }
+    auto end  () const { return m_instructions.end(); }
+    
+  private:
+    
+    DxbcDecodeArena                     m_arena;
+    std::vector<DxbcShaderInstruction>  m_instructions;
+    
+  };
+  
+}
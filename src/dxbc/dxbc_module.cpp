@@ -43,6 +43,11 @@ namespace dxvk {
     if (m_shexChunk == nullptr)
       throw DxvkError("DxbcModule::compile: No SHDR/SHEX chunk");
     
+    // Decode the instruction stream only once
+    // and use it for both the analyzer and the
+    // compiler, which process the same code
+    DxbcInstructionStream instructions(m_shexChunk->slice());
+    
     DxbcAnalysisInfo analysisInfo;
     
     DxbcAnalyzer analyzer(moduleInfo,
@@ -50,7 +55,7 @@ namespace dxvk {
       m_isgnChunk, m_osgnChunk,
       analysisInfo);
     
-    this->runAnalyzer(analyzer, m_shexChunk->slice());
+    this->runAnalyzer(analyzer, instructions);
     
     DxbcCompiler compiler(
       fileName, moduleInfo,
@@ -58,7 +63,7 @@ namespace dxvk {
       m_isgnChunk, m_osgnChunk,
       analysisInfo);
     
-    this->runCompiler(compiler, m_shexChunk->slice());
+    this->runCompiler(compiler, instructions);
     
     return compiler.finalize();
   }
@@ -85,29 +90,17 @@ namespace dxvk {
 
   void DxbcModule::runAnalyzer(
           DxbcAnalyzer&       analyzer,
-          DxbcCodeSlice       slice) const {
-    DxbcDecodeContext decoder;
-    
-    while (!slice.atEnd()) {
-      decoder.decodeInstruction(slice);
-      
-      analyzer.processInstruction(
-        decoder.getInstruction());
-    }
+    const DxbcInstructionStream& instructions) const {
+    for (const auto& ins : instructions)
+      analyzer.processInstruction(ins);
   }
   
   
   void DxbcModule::runCompiler(
           DxbcCompiler&       compiler,
-          DxbcCodeSlice       slice) const {
-    DxbcDecodeContext decoder;
-    
-    while (!slice.atEnd()) {
-      decoder.decodeInstruction(slice);
-      
-      compiler.processInstruction(
-        decoder.getInstruction());
-    }
+    const DxbcInstructionStream& instructions) const {
+    for (const auto& ins : instructions)
+      compiler.processInstruction(ins);
   }
   
 }
@@ -84,11 +84,11 @@ namespace dxvk {
     
     void runAnalyzer(
             DxbcAnalyzer&       analyzer,
-            DxbcCodeSlice       slice) const;
+      const DxbcInstructionStream& instructions) const;
     
     void runCompiler(
             DxbcCompiler&       compiler,
-            DxbcCodeSlice       slice) const;
+      const DxbcInstructionStream& instructions) const;
     
   };
   
@@ -21,6 +21,8 @@ namespace dxvk {
      && (devInfo.coreSubgroup.supportedOperations & VK_SUBGROUP_FEATURE_BALLOT_BIT);
     
     zeroInitWorkgroupMemory = options.zeroInitWorkgroupMemory;
+    promoteTempRegisters    = options.promoteTempRegisters;
+    eliminateDeadCode       = options.eliminateDeadCode;
     
     // Disable early discard on AMD due to GPU hangs
     // Disable early discard on Nvidia because it may hurt performance
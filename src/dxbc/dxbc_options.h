@@ -19,6 +19,13 @@ namespace dxvk {
 
     /// Clear thread-group shared memory to zero
     bool zeroInitWorkgroupMemory = false;
+
+    /// Promote temporary registers to function-local
+    /// variables and forward values within blocks
+    bool promoteTempRegisters = false;
+
+    /// Remove unused code, resources and inputs
+    bool eliminateDeadCode = false;
   };
   
 }
\ No newline at end of file
@@ -89,6 +89,31 @@ namespace dxvk {
   }
   
   
+  uint32_t DxvkAdapter::transferQueueFamily() const {
+    for (uint32_t i = 0; i < m_queueFamilies.size(); i++) {
+      VkQueueFlags flags = m_queueFamilies[i].queueFlags;
+      
+      if ((flags & VK_QUEUE_TRANSFER_BIT)
+       && !(flags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)))
+        return i;
+    }
+    
+    return VK_QUEUE_FAMILY_IGNORED;
+  }
+  
+  
+  bool DxvkAdapter::checkMemoryTypeSupport(VkMemoryPropertyFlags flags) const {
+    VkPhysicalDeviceMemoryProperties props = memoryProperties();
+    
+    for (uint32_t i = 0; i < props.memoryTypeCount; i++) {
+      if ((props.memoryTypes[i].propertyFlags & flags) == flags)
+        return true;
+    }
+    
+    return false;
+  }
+  
+  
   bool DxvkAdapter::checkFeatureSupport(const DxvkDeviceFeatures& required) const {
     return (m_deviceFeatures.core.features.robustBufferAccess
                 || !required.core.features.robustBufferAccess)
@@ -286,6 +311,17 @@ namespace dxvk {
       presentQueue.queueFamilyIndex        = pIndex;
       queueInfos.push_back(presentQueue);
     }
+    
+    // Optionally create a queue on a dedicated transfer
+    // queue family, which is used for resource uploads
+    uint32_t tIndex = this->transferQueueFamily();
+    
+    if (m_instance->options().enableTransferQueue
+     && tIndex != VK_QUEUE_FAMILY_IGNORED) {
+      VkDeviceQueueCreateInfo transferQueue = graphicsQueue;
+      transferQueue.queueFamilyIndex        = tIndex;
+      queueInfos.push_back(transferQueue);
+    }
 
     VkDeviceCreateInfo info;
     info.sType                      = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
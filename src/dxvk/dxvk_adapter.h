@@ -174,6 +174,25 @@ namespace dxvk {
      */
     uint32_t presentQueueFamily() const;
     
+    /**
+     * \brief Dedicated transfer queue family index
+     * 
+     * Looks for a queue family that supports transfer
+     * operations, but neither graphics nor compute.
+     * \returns Transfer queue family index, or
+     *    \c VK_QUEUE_FAMILY_IGNORED if none exists
+     */
+    uint32_t transferQueueFamily() const;
+    
+    /**
+     * \brief Checks for a memory type with the given properties
+     * 
+     * \param [in] flags Required memory property flags
+     * \returns \c true if any memory type supports all flags
+     */
+    bool checkMemoryTypeSupport(
+      VkMemoryPropertyFlags flags) const;
+    
     /**
      * \brief Tests whether all required features are supported
      * 
@@ -1,7 +1,48 @@
+#include <algorithm>
+
 #include "dxvk_barrier.h"
 
 namespace dxvk {
   
+  void DxvkBarrierRangeSet::insert(
+          VkDeviceSize              offset,
+          VkDeviceSize              length) {
+    Range range = { offset, offset + length };
+
+    // Find the first range that ends at or after the
+    // start of the new range, i.e. the first range
+    // that may need to be merged with the new one.
+    auto first = std::lower_bound(m_ranges.begin(), m_ranges.end(), range.begin,
+      [] (const Range& r, VkDeviceSize v) { return r.end < v; });
+
+    auto last = first;
+
+    while (last != m_ranges.end() && last->begin <= range.end) {
+      range.begin = std::min(range.begin, last->begin);
+      range.end   = std::max(range.end,   last->end);
+      last++;
+    }
+
+    if (first == last) {
+      m_ranges.insert(first, range);
+    } else {
+      *first = range;
+      m_ranges.erase(first + 1, last);
+    }
+  }
+
+
+  bool DxvkBarrierRangeSet::overlaps(
+          VkDeviceSize              offset,
+          VkDeviceSize              length) const {
+    auto range = std::upper_bound(m_ranges.begin(), m_ranges.end(), offset,
+      [] (VkDeviceSize v, const Range& r) { return v < r.end; });
+
+    return range != m_ranges.end()
+        && range->begin < offset + length;
+  }
+
+
   DxvkBarrierSet:: DxvkBarrierSet() { }
   DxvkBarrierSet::~DxvkBarrierSet() { }
   
@@ -30,7 +71,11 @@ namespace dxvk {
       m_bufBarriers.push_back(barrier);
     }
 
-    m_bufSlices.push_back({ bufSlice, access });
+    BufSlices& slices = this->getBufSlices(bufSlice.handle());
+    slices.access.insert(bufSlice.offset(), bufSlice.length());
+
+    if (access.test(DxvkAccess::Write))
+      slices.writes.insert(bufSlice.offset(), bufSlice.length());
   }
   
   
@@ -67,21 +112,67 @@ namespace dxvk {
       m_imgBarriers.push_back(barrier);
     }
 
-    m_imgSlices.push_back({ image.ptr(), subresources, access });
+    ImgSlices& slices = this->getImgSlices(image.ptr());
+
+    // Merge with an existing entry if the subresource ranges
+    // are adjacent along one axis and identical along the
+    // other, which is the common case for mip generation
+    // and per-layer clears. This keeps the list short.
+    for (auto& entry : slices.slices) {
+      VkImageSubresourceRange& subres = entry.subres;
+
+      if (entry.access != access)
+        continue;
+
+      if (subres.baseMipLevel == subresources.baseMipLevel
+       && subres.levelCount   == subresources.levelCount) {
+        if (subres.baseArrayLayer + subres.layerCount == subresources.baseArrayLayer) {
+          subres.layerCount += subresources.layerCount;
+          return;
+        }
+
+        if (subresources.baseArrayLayer + subresources.layerCount == subres.baseArrayLayer) {
+          subres.baseArrayLayer = subresources.baseArrayLayer;
+          subres.layerCount    += subresources.layerCount;
+          return;
+        }
+      }
+
+      if (subres.baseArrayLayer == subresources.baseArrayLayer
+       && subres.layerCount     == subresources.layerCount) {
+        if (subres.baseMipLevel + subres.levelCount == subresources.baseMipLevel) {
+          subres.levelCount += subresources.levelCount;
+          return;
+        }
+
+        if (subresources.baseMipLevel + subresources.levelCount == subres.baseMipLevel) {
+          subres.baseMipLevel = subresources.baseMipLevel;
+          subres.levelCount  += subresources.levelCount;
+          return;
+        }
+      }
+    }
+
+    slices.slices.push_back({ subresources, access });
   }
   
   
   bool DxvkBarrierSet::isBufferDirty(
     const DxvkPhysicalBufferSlice&  bufSlice,
           DxvkAccessFlags           bufAccess) {
-    bool result = false;
+    auto entry = m_bufIndices.find(bufSlice.handle());
 
-    for (uint32_t i = 0; i < m_bufSlices.size() && !result; i++) {
-      result = (bufSlice.overlaps(m_bufSlices[i].slice))
-            && (bufAccess | m_bufSlices[i].access).test(DxvkAccess::Write);
-    }
+    if (entry == m_bufIndices.end())
+      return false;
 
-    return result;
+    // If the given access is a write, any previous access
+    // to an overlapping range is a hazard. Otherwise, only
+    // previous writes need to be considered.
+    const BufSlices& slices = m_bufSlices[entry->second];
+
+    return bufAccess.test(DxvkAccess::Write)
+      ? slices.access.overlaps(bufSlice.offset(), bufSlice.length())
+      : slices.writes.overlaps(bufSlice.offset(), bufSlice.length());
   }
 
 
@@ -89,12 +180,18 @@ namespace dxvk {
     const Rc<DxvkImage>&            image,
     const VkImageSubresourceRange&  imgSubres,
           DxvkAccessFlags           imgAccess) {
+    auto entry = m_imgIndices.find(image.ptr());
+
+    if (entry == m_imgIndices.end())
+      return false;
+
+    const ImgSlices& slices = m_imgSlices[entry->second];
     bool result = false;
 
-    for (uint32_t i = 0; i < m_imgSlices.size() && !result; i++) {
-      const VkImageSubresourceRange& dstSubres = m_imgSlices[i].subres;
+    for (uint32_t i = 0; i < slices.slices.size() && !result; i++) {
+      const VkImageSubresourceRange& dstSubres = slices.slices[i].subres;
 
-      result = (image == m_imgSlices[i].image) && (imgAccess | m_imgSlices[i].access).test(DxvkAccess::Write)
+      result = (imgAccess | slices.slices[i].access).test(DxvkAccess::Write)
             && imgSubres.baseArrayLayer < dstSubres.baseArrayLayer + dstSubres.layerCount
             && imgSubres.baseArrayLayer + imgSubres.layerCount     > dstSubres.baseArrayLayer
             && imgSubres.baseMipLevel   < dstSubres.baseMipLevel   + dstSubres.levelCount
@@ -113,12 +210,17 @@ namespace dxvk {
       if (srcFlags == 0) srcFlags = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
       if (dstFlags == 0) dstFlags = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
       
+      this->mergeBufferBarriers();
+      this->mergeImageBarriers();
+      
       commandList->cmdPipelineBarrier(
         srcFlags, dstFlags, 0,
         m_memBarriers.size(), m_memBarriers.data(),
         m_bufBarriers.size(), m_bufBarriers.data(),
         m_imgBarriers.size(), m_imgBarriers.data());
       
+      commandList->addStatCtr(DxvkStatCounter::CmdBarrierCount, 1);
+      
       this->reset();
     }
   }
@@ -132,8 +234,128 @@ namespace dxvk {
     m_bufBarriers.resize(0);
     m_imgBarriers.resize(0);
 
-    m_bufSlices.resize(0);
-    m_imgSlices.resize(0);
+    // Keep the per-resource entries around so that
+    // their storage can be reused for the next batch
+    for (uint32_t i = 0; i < m_bufSliceCount; i++) {
+      m_bufSlices[i].access.clear();
+      m_bufSlices[i].writes.clear();
+    }
+
+    for (uint32_t i = 0; i < m_imgSliceCount; i++)
+      m_imgSlices[i].slices.clear();
+
+    m_bufIndices.clear();
+    m_imgIndices.clear();
+
+    m_bufSliceCount = 0;
+    m_imgSliceCount = 0;
+  }
+  
+  
+  void DxvkBarrierSet::mergeBufferBarriers() {
+    if (m_bufBarriers.size() < 2)
+      return;
+    
+    // Sort by buffer and offset so that barriers for adjacent
+    // or overlapping ranges of the same buffer can be merged
+    // into a single barrier. Combining the access masks is
+    // safe since all barriers are part of the same command.
+    std::sort(m_bufBarriers.begin(), m_bufBarriers.end(),
+      [] (const VkBufferMemoryBarrier& a, const VkBufferMemoryBarrier& b) {
+        if (a.buffer != b.buffer)
+          return a.buffer < b.buffer;
+        return a.offset < b.offset;
+      });
+    
+    size_t count = 0;
+    
+    for (size_t i = 1; i < m_bufBarriers.size(); i++) {
+      VkBufferMemoryBarrier& dst = m_bufBarriers[count];
+      VkBufferMemoryBarrier& src = m_bufBarriers[i];
+      
+      if (dst.buffer == src.buffer && dst.offset + dst.size >= src.offset) {
+        dst.size           = std::max(dst.offset + dst.size, src.offset + src.size) - dst.offset;
+        dst.srcAccessMask |= src.srcAccessMask;
+        dst.dstAccessMask |= src.dstAccessMask;
+      } else {
+        m_bufBarriers[++count] = src;
+      }
+    }
+    
+    m_bufBarriers.resize(count + 1);
+  }
+  
+  
+  void DxvkBarrierSet::mergeImageBarriers() {
+    if (m_imgBarriers.size() < 2)
+      return;
+    
+    // Image barriers are usually generated in order when
+    // processing subresources one by one, so we only try
+    // to merge consecutive barriers for the same image.
+    size_t count = 0;
+    
+    for (size_t i = 1; i < m_imgBarriers.size(); i++) {
+      VkImageMemoryBarrier& dst = m_imgBarriers[count];
+      VkImageMemoryBarrier& src = m_imgBarriers[i];
+      
+      VkImageSubresourceRange& dstSubres = dst.subresourceRange;
+      VkImageSubresourceRange& srcSubres = src.subresourceRange;
+      
+      bool merge = dst.image     == src.image
+                && dst.oldLayout == src.oldLayout
+                && dst.newLayout == src.newLayout
+                && dstSubres.aspectMask == srcSubres.aspectMask;
+      
+      if (merge) {
+        if (dstSubres.baseMipLevel == srcSubres.baseMipLevel
+         && dstSubres.levelCount   == srcSubres.levelCount
+         && dstSubres.baseArrayLayer + dstSubres.layerCount == srcSubres.baseArrayLayer) {
+          dstSubres.layerCount += srcSubres.layerCount;
+        } else if (dstSubres.baseArrayLayer == srcSubres.baseArrayLayer
+                && dstSubres.layerCount     == srcSubres.layerCount
+                && dstSubres.baseMipLevel + dstSubres.levelCount == srcSubres.baseMipLevel) {
+          dstSubres.levelCount += srcSubres.levelCount;
+        } else {
+          merge = false;
+        }
+      }
+      
+      if (merge) {
+        dst.srcAccessMask |= src.srcAccessMask;
+        dst.dstAccessMask |= src.dstAccessMask;
+      } else {
+        m_imgBarriers[++count] = src;
+      }
+    }
+    
+    m_imgBarriers.resize(count + 1);
+  }
+  
+  
+  DxvkBarrierSet::BufSlices& DxvkBarrierSet::getBufSlices(VkBuffer buffer) {
+    auto entry = m_bufIndices.insert({ buffer, m_bufSliceCount });
+
+    if (entry.second) {
+      if (m_bufSliceCount == m_bufSlices.size())
+        m_bufSlices.emplace_back();
+      m_bufSliceCount += 1;
+    }
+
+    return m_bufSlices[entry.first->second];
+  }
+
+
+  DxvkBarrierSet::ImgSlices& DxvkBarrierSet::getImgSlices(DxvkImage* image) {
+    auto entry = m_imgIndices.insert({ image, m_imgSliceCount });
+
+    if (entry.second) {
+      if (m_imgSliceCount == m_imgSlices.size())
+        m_imgSlices.emplace_back();
+      m_imgSliceCount += 1;
+    }
+
+    return m_imgSlices[entry.first->second];
   }
   
   
@@ -1,11 +1,65 @@
 #pragma once
 
+#include <unordered_map>
+
 #include "dxvk_buffer.h"
 #include "dxvk_cmdlist.h"
 #include "dxvk_image.h"
 
 namespace dxvk {
   
+  /**
+   * \brief Barrier range set
+   * 
+   * Stores a sorted list of disjoint, non-adjacent
+   * ranges. Overlapping or adjacent ranges are merged
+   * on insertion, so that overlap checks can be done
+   * with a binary search rather than a linear scan.
+   */
+  class DxvkBarrierRangeSet {
+
+  public:
+
+    /**
+     * \brief Adds a range to the set
+     * 
+     * \param [in] offset Range offset
+     * \param [in] length Range length
+     */
+    void insert(
+            VkDeviceSize              offset,
+            VkDeviceSize              length);
+
+    /**
+     * \brief Checks whether a range overlaps with the set
+     * 
+     * \param [in] offset Range offset
+     * \param [in] length Range length
+     * \returns \c true if any range in the set overlaps
+     */
+    bool overlaps(
+            VkDeviceSize              offset,
+            VkDeviceSize              length) const;
+
+    /**
+     * \brief Removes all ranges
+     */
+    void clear() {
+      m_ranges.clear();
+    }
+
+  private:
+
+    struct Range {
+      VkDeviceSize begin;
+      VkDeviceSize end;
+    };
+
+    std::vector<Range> m_ranges;
+
+  };
+
+
   /**
    * \brief Barrier set
    * 
@@ -53,16 +107,19 @@ namespace dxvk {
     
   private:
 
-    struct BufSlice {
-      DxvkPhysicalBufferSlice slice;
-      DxvkAccessFlags         access;
+    struct BufSlices {
+      DxvkBarrierRangeSet     access;
+      DxvkBarrierRangeSet     writes;
     };
 
     struct ImgSlice {
-      DxvkImage*              image;
       VkImageSubresourceRange subres;
       DxvkAccessFlags         access;
     };
+
+    struct ImgSlices {
+      std::vector<ImgSlice>   slices;
+    };
     
     VkPipelineStageFlags m_srcStages = 0;
     VkPipelineStageFlags m_dstStages = 0;
@@ -71,9 +128,21 @@ namespace dxvk {
     std::vector<VkBufferMemoryBarrier>  m_bufBarriers;
     std::vector<VkImageMemoryBarrier>   m_imgBarriers;
 
-    std::vector<BufSlice> m_bufSlices;
-    std::vector<ImgSlice> m_imgSlices;
+    std::unordered_map<VkBuffer,   uint32_t> m_bufIndices;
+    std::unordered_map<DxvkImage*, uint32_t> m_imgIndices;
+
+    std::vector<BufSlices> m_bufSlices;
+    std::vector<ImgSlices> m_imgSlices;
+
+    uint32_t m_bufSliceCount = 0;
+    uint32_t m_imgSliceCount = 0;
     
+    void mergeBufferBarriers();
+    void mergeImageBarriers();
+
+    BufSlices& getBufSlices(VkBuffer buffer);
+    ImgSlices& getImgSlices(DxvkImage* image);
+
     DxvkAccessFlags getAccessTypes(VkAccessFlags flags) const;
     
   };
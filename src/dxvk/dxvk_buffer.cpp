@@ -22,17 +22,37 @@ namespace dxvk {
 
 
   DxvkBuffer::~DxvkBuffer() {
-    
+    // The current slice is not owned by the buffer
+    // tracker, so we need to return it ourselves
+    if (m_arena != nullptr)
+      m_arena->free(m_physSlice);
   }
   
   
   DxvkPhysicalBufferSlice DxvkBuffer::allocPhysicalSlice() {
     std::unique_lock<sync::Spinlock> freeLock(m_freeMutex);
     
+    m_renameCount      += 1;
+    m_renamesSinceTrim += 1;
+    
+    if (m_arena != nullptr)
+      return m_arena->alloc(m_physSliceLength);
+    
     // If no slices are available, swap the two free lists.
+    // This is also a good point to check whether the current
+    // physical buffer is much larger than what we need.
     if (m_freeSlices.size() == 0) {
       std::unique_lock<sync::Spinlock> swapLock(m_swapMutex);
       std::swap(m_freeSlices, m_nextSlices);
+      
+      m_physSlicePeak = std::max(m_physSlicePeak,
+        m_physSlicePool - m_freeSlices.size());
+      
+      if (this->trimPhysicalSlices()) {
+        m_freeSlices.clear();
+        m_nextSlices.clear();
+        m_physBuffer = nullptr;
+      }
     }
       
     // If there are still no slices available, create a new
@@ -47,7 +67,15 @@ namespace dxvk {
           m_physSliceLength));
       }
       
-      m_physSliceCount *= 2;
+      m_physSlicePool     = m_physSliceCount;
+      m_physSlicePeak     = 0;
+      m_physSliceCount   *= 2;
+      m_renamesSinceTrim  = 0;
+      
+      if (m_physSlicePool >= 256) {
+        Logger::debug(str::format("DxvkBuffer: Buffer of size ", m_info.size,
+          " renamed ", m_renameCount, " times, now using ", m_physSlicePool, " slices"));
+      }
     }
     
     // Take the first slice from the queue
@@ -58,16 +86,50 @@ namespace dxvk {
   
   
   void DxvkBuffer::freePhysicalSlice(const DxvkPhysicalBufferSlice& slice) {
+    // Slices allocated from an arena are never reused
+    // by the buffer directly, return them to the arena
+    if (m_arena != nullptr && m_arena->free(slice))
+      return;
+    
     // Add slice to a separate free list to reduce lock contention.
     std::unique_lock<sync::Spinlock> swapLock(m_swapMutex);
 
     // Discard slices allocated from other physical buffers.
     // This may make descriptor set binding more efficient.
-    if (m_physBuffer->handle() == slice.handle())
+    if (m_physBuffer != nullptr && m_physBuffer->handle() == slice.handle())
       m_nextSlices.push_back(slice);
   }
   
   
+  bool DxvkBuffer::trimPhysicalSlices() {
+    // Only consider trimming after the buffer has gone through
+    // its slice pool a few times, so that the peak number of
+    // slices in use is representative of the working set.
+    if (m_renamesSinceTrim < 4 * m_physSlicePool || m_physSlicePool <= 4)
+      return false;
+    
+    VkDeviceSize peak = m_physSlicePeak;
+    
+    m_physSlicePeak    = 0;
+    m_renamesSinceTrim = 0;
+    
+    if (4 * peak > m_physSlicePool)
+      return false;
+    
+    // Allocate a new buffer that fits twice the peak working set
+    // and let the old buffer die once the GPU releases all of its
+    // slices. Those will be discarded in freePhysicalSlice.
+    m_physSliceCount = 2;
+    
+    while (m_physSliceCount < 2 * peak)
+      m_physSliceCount *= 2;
+    
+    Logger::debug(str::format("DxvkBuffer: Buffer of size ", m_info.size,
+      " trimmed from ", m_physSlicePool, " to ", m_physSliceCount, " slices"));
+    return true;
+  }
+  
+  
   Rc<DxvkPhysicalBuffer> DxvkBuffer::allocPhysicalBuffer(VkDeviceSize sliceCount) const {
     DxvkBufferCreateInfo createInfo = m_info;
     createInfo.size = sliceCount * m_physSliceStride;
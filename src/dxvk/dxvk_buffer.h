@@ -3,6 +3,7 @@
 #include <mutex>
 #include <vector>
 
+#include "dxvk_buffer_arena.h"
 #include "dxvk_buffer_res.h"
 
 namespace dxvk {
@@ -168,6 +169,19 @@ namespace dxvk {
       m_vertexStride = stride;
     }
     
+    /**
+     * \brief Enables arena allocation
+     * 
+     * Subsequent physical slices will be allocated
+     * from the given arena rather than from buffers
+     * owned by this buffer. Only small buffers that
+     * are frequently renamed should use this.
+     * \param [in] arena The buffer arena
+     */
+    void setArena(const Rc<DxvkBufferArena>& arena) {
+      m_arena = arena;
+    }
+    
     /**
      * \brief Allocates new physical resource
      * \returns The new backing buffer slice
@@ -204,12 +218,20 @@ namespace dxvk {
     VkDeviceSize m_physSliceLength  = 0;
     VkDeviceSize m_physSliceStride  = 0;
     VkDeviceSize m_physSliceCount   = 2;
+    VkDeviceSize m_physSlicePool    = 0;
+    VkDeviceSize m_physSlicePeak    = 0;
+
+    uint64_t m_renameCount          = 0;
+    uint64_t m_renamesSinceTrim     = 0;
 
     Rc<DxvkPhysicalBuffer>  m_physBuffer;
+    Rc<DxvkBufferArena>     m_arena;
     
     Rc<DxvkPhysicalBuffer> allocPhysicalBuffer(
             VkDeviceSize    sliceCount) const;
     
+    bool trimPhysicalSlices();
+    
     void lock();
     void unlock();
     
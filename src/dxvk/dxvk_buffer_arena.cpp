@@ -0,0 +1,123 @@
+#include "dxvk_buffer_arena.h"
+#include "dxvk_device.h"
+
+namespace dxvk {
+  
+  DxvkBufferArena::DxvkBufferArena(
+          DxvkDevice*           device,
+          VkMemoryPropertyFlags memFlags)
+  : m_device  (device),
+    m_memFlags(memFlags),
+    m_usage   (VK_BUFFER_USAGE_TRANSFER_SRC_BIT
+             | VK_BUFFER_USAGE_TRANSFER_DST_BIT
+             | VK_BUFFER_USAGE_UNIFORM_TEXEL_BUFFER_BIT
+             | VK_BUFFER_USAGE_STORAGE_TEXEL_BUFFER_BIT
+             | VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT
+             | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT
+             | VK_BUFFER_USAGE_INDEX_BUFFER_BIT
+             | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT
+             | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT) {
+    
+  }
+  
+  
+  DxvkBufferArena::~DxvkBufferArena() {
+    
+  }
+  
+  
+  bool DxvkBufferArena::supportsBuffer(
+    const DxvkBufferCreateInfo& info) const {
+    return info.size <= MaxSliceSize
+        && (info.usage & m_usage) == info.usage;
+  }
+  
+  
+  DxvkPhysicalBufferSlice DxvkBufferArena::alloc(
+          VkDeviceSize          size) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    
+    VkDeviceSize alignedSize = align(size, SliceAlignment);
+    
+    Page* page = m_page;
+    
+    if (page == nullptr || page->offset + alignedSize > PageSize)
+      page = this->nextPage();
+    
+    DxvkPhysicalBufferSlice slice = page->buffer->slice(page->offset, size);
+    
+    page->offset += alignedSize;
+    page->slices += 1;
+    return slice;
+  }
+  
+  
+  bool DxvkBufferArena::free(
+    const DxvkPhysicalBufferSlice& slice) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    
+    Page* page = this->findPage(slice.handle());
+    
+    if (page == nullptr)
+      return false;
+    
+    page->slices -= 1;
+    return true;
+  }
+  
+  
+  DxvkBufferArena::Page* DxvkBufferArena::findPage(
+          VkBuffer              handle) {
+    auto entry = m_pages.find(handle);
+    
+    return entry != m_pages.end()
+      ? &entry->second
+      : nullptr;
+  }
+  
+  
+  DxvkBufferArena::Page* DxvkBufferArena::nextPage() {
+    // Reuse the first page that is no longer referenced
+    // by any slice and that the GPU has finished using.
+    // Pages are only ever filled linearly, so checking
+    // the GPU status of the entire page is sufficient.
+    // Other unused pages age, and are released once
+    // they have not been needed for a while.
+    Page* reuse = nullptr;
+    
+    for (auto entry = m_pages.begin(); entry != m_pages.end(); ) {
+      Page& page = entry->second;
+      
+      if (&page == m_page || page.slices != 0 || page.buffer->isInUse()) {
+        page.idle = 0;
+      } else if (reuse == nullptr) {
+        page.idle = 0;
+        reuse = &page;
+      } else if (++page.idle >= MaxIdleCycles) {
+        entry = m_pages.erase(entry);
+        continue;
+      }
+      
+      entry++;
+    }
+    
+    if (reuse != nullptr) {
+      reuse->offset = 0;
+      m_page = reuse;
+      return m_page;
+    }
+    
+    DxvkBufferCreateInfo info;
+    info.size   = PageSize;
+    info.usage  = m_usage;
+    info.stages = 0;
+    info.access = 0;
+    
+    Rc<DxvkPhysicalBuffer> buffer = m_device->allocPhysicalBuffer(info, m_memFlags);
+    
+    m_page = &m_pages[buffer->handle()];
+    m_page->buffer = std::move(buffer);
+    return m_page;
+  }
+  
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <mutex>
+#include <unordered_map>
+
+#include "dxvk_buffer_res.h"
+
+namespace dxvk {
+  
+  class DxvkDevice;
+  
+  /**
+   * \brief Buffer arena
+   * 
+   * Suballocates physical buffer slices for small
+   * buffers from large, linearly allocated pages,
+   * so that renaming many small buffers does not
+   * spread their data across many Vulkan buffers.
+   * 
+   * A page is recycled once all slices allocated
+   * from it have been freed and the GPU no longer
+   * uses the page's physical buffer. Pages that
+   * stay unused for a while are released.
+   */
+  class DxvkBufferArena : public RcObject {
+    constexpr static VkDeviceSize PageSize      = 4 << 20;
+    constexpr static VkDeviceSize SliceAlignment = 256;
+    constexpr static uint32_t     MaxIdleCycles  = 16;
+  public:
+    
+    /// Maximum size of a single slice
+    constexpr static VkDeviceSize MaxSliceSize  = 64 << 10;
+    
+    DxvkBufferArena(
+            DxvkDevice*           device,
+            VkMemoryPropertyFlags memFlags);
+    
+    ~DxvkBufferArena();
+    
+    /**
+     * \brief Memory type flags
+     * \returns Memory type flags of all pages
+     */
+    VkMemoryPropertyFlags memFlags() const {
+      return m_memFlags;
+    }
+    
+    /**
+     * \brief Checks whether a buffer can use the arena
+     * 
+     * \param [in] info Buffer create info
+     * \returns \c true if slices of the buffer
+     *    can be allocated from the arena
+     */
+    bool supportsBuffer(
+      const DxvkBufferCreateInfo& info) const;
+    
+    /**
+     * \brief Allocates a buffer slice
+     * 
+     * \param [in] size Slice size, in bytes
+     * \returns The allocated slice
+     */
+    DxvkPhysicalBufferSlice alloc(
+            VkDeviceSize          size);
+    
+    /**
+     * \brief Frees a buffer slice
+     * 
+     * Must only be called once the slice is no
+     * longer accessed by the host or the GPU.
+     * \param [in] slice The slice to free
+     * \returns \c false if the slice was not
+     *    allocated from this arena
+     */
+    bool free(
+      const DxvkPhysicalBufferSlice& slice);
+    
+  private:
+    
+    struct Page {
+      Rc<DxvkPhysicalBuffer> buffer;
+      VkDeviceSize           offset = 0;
+      uint32_t               slices = 0;
+      uint32_t               idle   = 0;
+    };
+    
+    DxvkDevice*           m_device;
+    VkMemoryPropertyFlags m_memFlags;
+    VkBufferUsageFlags    m_usage;
+    
+    std::mutex            m_mutex;
+    Page*                 m_page = nullptr;
+    
+    std::unordered_map<VkBuffer, Page> m_pages;
+    
+    Page* findPage(
+            VkBuffer              handle);
+    
+    Page* nextPage();
+    
+  };
+  
+}
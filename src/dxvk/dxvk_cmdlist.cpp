@@ -7,6 +7,7 @@ namespace dxvk {
           DxvkDevice*       device,
           uint32_t          queueFamily)
   : m_vkd           (device->vkd()),
+    m_queueFamily   (queueFamily),
     m_cmdBuffersUsed(0),
     m_descriptorPoolTracker(device),
     m_stagingAlloc  (device) {
@@ -74,7 +75,14 @@ namespace dxvk {
     info.signalSemaphoreCount = wakeSemaphore == VK_NULL_HANDLE ? 0 : 1;
     info.pSignalSemaphores    = &wakeSemaphore;
     
-    return m_vkd->vkQueueSubmit(queue, 1, &info, m_fence);
+    VkResult status = m_vkd->vkQueueSubmit(queue, 1, &info, m_fence);
+    
+    // Staging memory owned by this command list will
+    // now be released eventually, so others may wait
+    if (status == VK_SUCCESS)
+      m_stagingAlloc.submit();
+    
+    return status;
   }
   
   
@@ -47,6 +47,17 @@ namespace dxvk {
             uint32_t          queueFamily);
     ~DxvkCommandList();
     
+    /**
+     * \brief Queue family
+     * 
+     * The queue family that the command
+     * list's command pool was created for.
+     * \returns Queue family index
+     */
+    uint32_t queueFamily() const {
+      return m_queueFamily;
+    }
+    
     /**
      * \brief Submits command list
      * 
@@ -129,10 +140,13 @@ namespace dxvk {
      * Adds a resource to the internal resource tracker.
      * Resources will be kept alive and "in use" until
      * the device can guarantee that the submission has
-     * completed.
+     * completed. Tracking a resource more than once per
+     * submission has no effect.
+     * \param [in] rc The resource to track
      */
-    void trackResource(Rc<DxvkResource> rc) {
-      m_resources.trackResource(std::move(rc));
+    template<typename T>
+    void trackResource(const Rc<T>& rc) {
+      m_resources.trackResource(rc.ptr());
     }
     
     /**
@@ -649,6 +663,7 @@ namespace dxvk {
   private:
     
     Rc<vk::DeviceFn>    m_vkd;
+    uint32_t            m_queueFamily;
     
     VkFence             m_fence;
     
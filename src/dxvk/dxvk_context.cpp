@@ -250,13 +250,20 @@ namespace dxvk {
           VkDeviceSize          offset,
           VkDeviceSize          length,
           uint32_t              value) {
-    this->spillRenderPass();
-    
     if (length == buffer->info().size)
       length = align(length, 4);
     
-    auto slice = buffer->subSlice(offset, length);
-
+    this->clearPhysicalBuffer(buffer,
+      buffer->subSlice(offset, length), value);
+  }
+  
+  
+  void DxvkContext::clearPhysicalBuffer(
+    const Rc<DxvkBuffer>&           buffer,
+    const DxvkPhysicalBufferSlice&  slice,
+          uint32_t                  value) {
+    this->spillRenderPass();
+    
     if (m_barriers.isBufferDirty(slice, DxvkAccess::Write))
       m_barriers.recordCommands(m_cmd);
     
@@ -1451,14 +1458,25 @@ namespace dxvk {
         physicalSlice.length(),
         data);
     } else {
-      auto slice = m_cmd->stagedAlloc(size);
-      std::memcpy(slice.mapPtr, data, size);
-
-      m_cmd->stagedBufferCopy(
-        physicalSlice.handle(),
-        physicalSlice.offset(),
-        physicalSlice.length(),
-        slice);
+      // Split large uploads into chunks of the default staging
+      // buffer size, so that they can be served by the staging
+      // ring or by recycled staging buffers respectively.
+      auto srcData = reinterpret_cast<const char*>(data);
+
+      for (VkDeviceSize chunkOffset = 0; chunkOffset < size; ) {
+        VkDeviceSize chunkSize = std::min<VkDeviceSize>(
+          size - chunkOffset, DxvkDevice::DefaultStagingBufferSize);
+
+        auto slice = m_cmd->stagedAlloc(chunkSize);
+        std::memcpy(slice.mapPtr, srcData + chunkOffset, chunkSize);
+
+        m_cmd->stagedBufferCopy(
+          physicalSlice.handle(),
+          physicalSlice.offset() + chunkOffset,
+          chunkSize, slice);
+        
+        chunkOffset += chunkSize;
+      }
     }
 
     m_barriers.accessBuffer(
@@ -1501,7 +1519,7 @@ namespace dxvk {
     auto dstData = reinterpret_cast<char*>(slice.mapPtr);
     auto srcData = reinterpret_cast<const char*>(data);
     
-    util::packImageData(dstData, srcData,
+    m_device->imagePacker()->packImageData(dstData, srcData,
       elementCount, formatInfo->elementSize,
       pitchPerRow, pitchPerLayer);
     
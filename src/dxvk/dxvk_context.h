@@ -212,6 +212,22 @@ namespace dxvk {
             VkDeviceSize          length,
             uint32_t              value);
     
+    /**
+     * \brief Clears a physical buffer slice with a fixed value
+     * 
+     * Unlike \ref clearBuffer, this writes to the given
+     * backing storage even if the buffer has been renamed
+     * since the slice was queried. The slice length must
+     * be a multiple of four.
+     * \param [in] buffer The buffer that owns the slice
+     * \param [in] slice The physical slice to clear
+     * \param [in] value Clear value
+     */
+    void clearPhysicalBuffer(
+      const Rc<DxvkBuffer>&           buffer,
+      const DxvkPhysicalBufferSlice&  slice,
+            uint32_t                  value);
+    
     /**
      * \brief Clears a buffer view
      * 
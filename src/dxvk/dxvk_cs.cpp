@@ -113,21 +113,26 @@ namespace dxvk {
   }
   
   
-  void DxvkCsThread::dispatchChunk(DxvkCsChunkRef&& chunk) {
+  uint64_t DxvkCsThread::dispatchChunk(DxvkCsChunkRef&& chunk) {
+    uint64_t seq;
+    
     { std::unique_lock<std::mutex> lock(m_mutex);
       m_chunksQueued.push(std::move(chunk));
-      m_chunksPending += 1;
+      seq = ++m_chunksDispatched;
     }
     
     m_condOnAdd.notify_one();
+    return seq;
   }
   
   
-  void DxvkCsThread::synchronize() {
+  void DxvkCsThread::synchronize(uint64_t seq) {
     std::unique_lock<std::mutex> lock(m_mutex);
     
-    m_condOnSync.wait(lock, [this] {
-      return m_chunksPending == 0;
+    seq = std::min(seq, m_chunksDispatched);
+    
+    m_condOnSync.wait(lock, [this, seq] {
+      return m_chunksExecuted >= seq;
     });
   }
   
@@ -140,8 +145,8 @@ namespace dxvk {
     while (!m_stopped.load()) {
       { std::unique_lock<std::mutex> lock(m_mutex);
         if (chunk) {
-          if (--m_chunksPending == 0)
-            m_condOnSync.notify_one();
+          m_chunksExecuted += 1;
+          m_condOnSync.notify_one();
           
           chunk = DxvkCsChunkRef();
         }
@@ -82,6 +82,48 @@ namespace dxvk {
   };
   
   
+  /**
+   * \brief Typed command with inline data
+   * 
+   * Stores a function object as well as a small
+   * payload, which is stored directly behind the
+   * command within the chunk's memory. The function
+   * object receives a pointer to that payload.
+   */
+  template<typename T>
+  class alignas(16) DxvkCsDataCmd : public DxvkCsCmd {
+    
+  public:
+    
+    DxvkCsDataCmd(T&& cmd)
+    : m_command(std::move(cmd)) { }
+    
+    DxvkCsDataCmd             (DxvkCsDataCmd&&) = delete;
+    DxvkCsDataCmd& operator = (DxvkCsDataCmd&&) = delete;
+    
+    void exec(DxvkContext* ctx) const {
+      m_command(ctx, data());
+    }
+    
+    /**
+     * \brief Retrieves pointer to the payload
+     * \returns Pointer to the inline data
+     */
+    void* data() {
+      return reinterpret_cast<char*>(this) + sizeof(*this);
+    }
+    
+    const void* data() const {
+      return reinterpret_cast<const char*>(this) + sizeof(*this);
+    }
+    
+  private:
+    
+    T m_command;
+    
+  };
+  
+  
   /**
    * \brief Submission flags
    */
@@ -148,6 +190,43 @@ namespace dxvk {
       return true;
     }
     
+    /**
+     * \brief Tries to add a command with inline data
+     * 
+     * Works like \ref push, but also reserves the given
+     * amount of memory for the command's payload, which
+     * the caller must fill in before the chunk is
+     * submitted.
+     * \param [in] command The command to add
+     * \param [in] size Size of the payload, in bytes
+     * \returns Pointer to the payload, or \c nullptr
+     *          if a new chunk needs to be allocated
+     */
+    template<typename T>
+    void* pushData(T& command, size_t size) {
+      using FuncType = DxvkCsDataCmd<T>;
+      
+      size_t cmdSize = sizeof(FuncType) + align(size, alignof(FuncType));
+      
+      if (m_commandOffset + cmdSize > MaxBlockSize)
+        return nullptr;
+      
+      DxvkCsCmd* tail = m_tail;
+      FuncType*  func = new (m_data + m_commandOffset)
+        FuncType(std::move(command));
+      
+      m_tail = func;
+      
+      if (tail != nullptr)
+        tail->setNext(m_tail);
+      else
+        m_head = m_tail;
+      
+      m_commandCount  += 1;
+      m_commandOffset += cmdSize;
+      return func->data();
+    }
+    
     /**
      * \brief Initializes chunk for recording
      * \param [in] flags Chunk flags
@@ -321,6 +400,8 @@ namespace dxvk {
     
   public:
     
+    constexpr static uint64_t SynchronizeAll = ~0ull;
+    
     DxvkCsThread(const Rc<DxvkContext>& context);
     ~DxvkCsThread();
     
@@ -329,19 +410,34 @@ namespace dxvk {
      * 
      * Can be used to efficiently play back large
      * command lists recorded on another thread.
+     * Chunks are numbered sequentially, starting
+     * at one, in the order they are dispatched.
      * \param [in] chunk The chunk to dispatch
+     * \returns Sequence number of the chunk
      */
-    void dispatchChunk(DxvkCsChunkRef&& chunk);
+    uint64_t dispatchChunk(DxvkCsChunkRef&& chunk);
     
     /**
      * \brief Synchronizes with the thread
      * 
-     * This waits for all chunks in the dispatch
-     * queue to be processed by the thread. Note
-     * that this does \e not implicitly call
-     * \ref flush.
+     * This waits for all chunks up to and including
+     * the given sequence number to be processed by
+     * the thread. Note that this does \e not
+     * implicitly call \ref flush.
+     * \param [in] seq Sequence number to wait for
+     */
+    void synchronize(uint64_t seq = SynchronizeAll);
+    
+    /**
+     * \brief Sequence number of last dispatched chunk
+     * 
+     * Must only be called from the thread that
+     * dispatches chunks to the CS thread.
+     * \returns Last dispatched sequence number
      */
-    void synchronize();
+    uint64_t lastSequenceNumber() const {
+      return m_chunksDispatched;
+    }
     
   private:
     
@@ -354,7 +450,8 @@ namespace dxvk {
     std::queue<DxvkCsChunkRef>  m_chunksQueued;
     dxvk::thread                m_thread;
     
-    uint32_t                    m_chunksPending = 0;
+    uint64_t                    m_chunksDispatched = 0ull;
+    uint64_t                    m_chunksExecuted   = 0ull;
     
     void threadFunc();
     
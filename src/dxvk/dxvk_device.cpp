@@ -22,6 +22,7 @@ namespace dxvk {
     m_metaMipGenObjects (new DxvkMetaMipGenObjects  (vkd)),
     m_metaPackObjects   (new DxvkMetaPackObjects    (vkd)),
     m_metaResolveObjects(new DxvkMetaResolveObjects (vkd)),
+    m_imagePacker       (new DxvkImagePacker        ()),
     m_unboundResources  (this),
     m_submissionQueue   (this) {
     m_graphicsQueue.queueFamily = m_adapter->graphicsQueueFamily();
@@ -34,6 +35,25 @@ namespace dxvk {
     m_vkd->vkGetDeviceQueue(m_vkd->device(),
       m_presentQueue.queueFamily, 0,
       &m_presentQueue.queueHandle);
+    
+    uint32_t transferQueueFamily = m_adapter->transferQueueFamily();
+    
+    if (m_options.enableTransferQueue
+     && transferQueueFamily != VK_QUEUE_FAMILY_IGNORED) {
+      m_transferQueue.queueFamily = transferQueueFamily;
+      
+      m_vkd->vkGetDeviceQueue(m_vkd->device(),
+        m_transferQueue.queueFamily, 0,
+        &m_transferQueue.queueHandle);
+    }
+    
+    if (m_options.stagingRingSize > 0) {
+      m_stagingRing = new DxvkStagingRing(this,
+        VkDeviceSize(m_options.stagingRingSize) << 20);
+    }
+
+    if (m_options.enableShaderCache)
+      m_shaderCache = new DxvkShaderCache(m_options);
   }
   
   
@@ -41,6 +61,10 @@ namespace dxvk {
     // Wait for all pending Vulkan commands to be
     // executed before we destroy any resources.
     m_vkd->vkDeviceWaitIdle(m_vkd->device());
+    
+    Logger::debug(str::format("DXVK: Shader code: ",
+      m_shaderCodeSize.load() >> 10, " kB, compressed to ",
+      m_shaderCompressedCodeSize.load() >> 10, " kB"));
   }
 
 
@@ -94,6 +118,21 @@ namespace dxvk {
   }
   
   
+  Rc<DxvkBufferArena> DxvkDevice::getBufferArena(
+          VkMemoryPropertyFlags memoryType) {
+    std::lock_guard<std::mutex> lock(m_bufferArenaLock);
+    
+    for (const auto& arena : m_bufferArenas) {
+      if (arena->memFlags() == memoryType)
+        return arena;
+    }
+    
+    Rc<DxvkBufferArena> arena = new DxvkBufferArena(this, memoryType);
+    m_bufferArenas.push_back(arena);
+    return arena;
+  }
+  
+  
   void DxvkDevice::recycleStagingBuffer(const Rc<DxvkStagingBuffer>& buffer) {
     // Drop staging buffers that are bigger than the
     // standard ones to save memory, recycle the rest
@@ -114,6 +153,18 @@ namespace dxvk {
     
     return cmdList;
   }
+  
+  
+  Rc<DxvkCommandList> DxvkDevice::createTransferCommandList() {
+    Rc<DxvkCommandList> cmdList = m_recycledTransferCommandLists.retrieveObject();
+    
+    if (cmdList == nullptr) {
+      cmdList = new DxvkCommandList(this,
+        m_transferQueue.queueFamily);
+    }
+    
+    return cmdList;
+  }
 
 
   Rc<DxvkDescriptorPool> DxvkDevice::createDescriptorPool() {
@@ -221,6 +272,13 @@ namespace dxvk {
     result.setCtr(DxvkStatCounter::PipeCountGraphics, pipe.numGraphicsPipelines);
     result.setCtr(DxvkStatCounter::PipeCountCompute,  pipe.numComputePipelines);
     
+    if (m_stagingRing != nullptr) {
+      DxvkStagingRingStats ring = m_stagingRing->getStats();
+      result.setCtr(DxvkStatCounter::StagingRingStalls,    ring.stallCount);
+      result.setCtr(DxvkStatCounter::StagingRingStallTime, ring.stallTimeUs);
+      result.setCtr(DxvkStatCounter::StagingRingFallbacks, ring.fallbackCount);
+    }
+    
     std::lock_guard<sync::Spinlock> lock(m_statLock);
     result.merge(m_statCounters);
     return result;
@@ -238,6 +296,9 @@ namespace dxvk {
 
 
   void DxvkDevice::registerShader(const Rc<DxvkShader>& shader) {
+    m_shaderCodeSize           += shader->codeSize();
+    m_shaderCompressedCodeSize += shader->compressedCodeSize();
+    
     m_pipelineManager->registerShader(shader);
   }
   
@@ -271,6 +332,10 @@ namespace dxvk {
       commandList->trackResource(wakeSync);
     }
     
+    VkQueue queue = commandList->queueFamily() == m_graphicsQueue.queueFamily
+      ? m_graphicsQueue.queueHandle
+      : m_transferQueue.queueHandle;
+    
     VkResult status;
     
     { // Queue submissions are not thread safe
@@ -281,8 +346,7 @@ namespace dxvk {
       m_statCounters.addCtr(DxvkStatCounter::QueueSubmitCount, 1);
       
       status = commandList->submit(
-        m_graphicsQueue.queueHandle,
-        waitSemaphore, wakeSemaphore);
+        queue, waitSemaphore, wakeSemaphore);
     }
     
     if (status == VK_SUCCESS) {
@@ -302,8 +366,54 @@ namespace dxvk {
   }
   
   
+  void DxvkDevice::waitForResource(const Rc<DxvkResource>& resource) {
+    this->waitForCondition([&resource] {
+      return !resource->isInUse();
+    });
+  }
+  
+  
+  void DxvkDevice::waitForEvent(const Rc<DxvkEvent>& event) {
+    this->waitForCondition([&event] {
+      return event->getStatus() == DxvkEventStatus::Signaled;
+    });
+  }
+  
+  
+  template<typename Pred>
+  void DxvkDevice::waitForCondition(const Pred& pred) {
+    if (pred())
+      return;
+    
+    // Most waits are short, so spin for a little while
+    // before putting the thread to sleep, since waking
+    // it up again adds some latency.
+    auto t0 = std::chrono::high_resolution_clock::now();
+    auto t1 = t0 + std::chrono::microseconds(m_options.syncSpinTime);
+    
+    while (std::chrono::high_resolution_clock::now() < t1) {
+      if (pred())
+        return;
+      
+      dxvk::this_thread::yield();
+    }
+    
+    m_submissionQueue.waitFor(pred);
+    
+    auto t2 = std::chrono::high_resolution_clock::now();
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1);
+    
+    std::lock_guard<sync::Spinlock> lock(m_statLock);
+    m_statCounters.addCtr(DxvkStatCounter::SyncWaitCount, 1);
+    m_statCounters.addCtr(DxvkStatCounter::SyncWaitTime,  us.count());
+  }
+  
+  
   void DxvkDevice::recycleCommandList(const Rc<DxvkCommandList>& cmdList) {
-    m_recycledCommandLists.returnObject(cmdList);
+    if (cmdList->queueFamily() == m_graphicsQueue.queueFamily)
+      m_recycledCommandLists.returnObject(cmdList);
+    else
+      m_recycledTransferCommandLists.returnObject(cmdList);
   }
   
 
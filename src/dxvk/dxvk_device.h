@@ -8,6 +8,7 @@
 #include "dxvk_extensions.h"
 #include "dxvk_framebuffer.h"
 #include "dxvk_image.h"
+#include "dxvk_image_packer.h"
 #include "dxvk_memory.h"
 #include "dxvk_meta_clear.h"
 #include "dxvk_options.h"
@@ -19,6 +20,7 @@
 #include "dxvk_renderpass.h"
 #include "dxvk_sampler.h"
 #include "dxvk_shader.h"
+#include "dxvk_shader_cache.h"
 #include "dxvk_stats.h"
 #include "dxvk_swapchain.h"
 #include "dxvk_sync.h"
@@ -106,6 +108,26 @@ namespace dxvk {
       return m_graphicsQueue;
     }
     
+    /**
+     * \brief Checks for a dedicated transfer queue
+     * \returns \c true if a transfer queue was created
+     */
+    bool hasTransferQueue() const {
+      return m_transferQueue.queueHandle != VK_NULL_HANDLE;
+    }
+    
+    /**
+     * \brief Transfer queue properties
+     * 
+     * Handle and queue family index of the dedicated
+     * transfer queue. Only valid if the device has
+     * been created with a transfer queue.
+     * \returns Transfer queue info
+     */
+    DxvkDeviceQueue transferQueue() const {
+      return m_transferQueue;
+    }
+    
     /**
      * \brief The adapter
      * 
@@ -162,6 +184,51 @@ namespace dxvk {
     Rc<DxvkStagingBuffer> allocStagingBuffer(
             VkDeviceSize size);
     
+    /**
+     * \brief Staging ring
+     * 
+     * Device-wide ring buffer for staging allocations.
+     * \returns The staging ring, or \c nullptr if the
+     *    ring has been disabled by the user.
+     */
+    DxvkStagingRing* stagingRing() const {
+      return m_stagingRing.ptr();
+    }
+    
+    /**
+     * \brief Image data packer
+     * 
+     * Device-wide helper to copy large amounts
+     * of image data into staging memory.
+     * \returns The image packer
+     */
+    DxvkImagePacker* imagePacker() const {
+      return m_imagePacker.ptr();
+    }
+    
+    /**
+     * \brief Persistent shader cache
+     * 
+     * Used by the client API to avoid recompiling
+     * shaders that were compiled in previous runs.
+     * \returns The shader cache, or \c nullptr if
+     *    the shader cache is disabled.
+     */
+    DxvkShaderCache* shaderCache() const {
+      return m_shaderCache.ptr();
+    }
+    
+    /**
+     * \brief Retrieves buffer arena
+     * 
+     * Returns the device-wide arena for the given
+     * memory type, creating it if necessary.
+     * \param [in] memoryType Memory type flags
+     * \returns The buffer arena
+     */
+    Rc<DxvkBufferArena> getBufferArena(
+            VkMemoryPropertyFlags memoryType);
+    
     /**
      * \brief Recycles a staging buffer
      * 
@@ -179,6 +246,16 @@ namespace dxvk {
      */
     Rc<DxvkCommandList> createCommandList();
     
+    /**
+     * \brief Creates a transfer command list
+     * 
+     * The command list can only be submitted to the
+     * transfer queue, and must therefore only be
+     * used if the device has a transfer queue.
+     * \returns The command list
+     */
+    Rc<DxvkCommandList> createTransferCommandList();
+    
     /**
      * \brief Creates a descriptor pool
      * 
@@ -304,6 +381,19 @@ namespace dxvk {
      * usage, draw calls, etc.
      */
     DxvkStatCounters getStatCounters();
+    
+    /**
+     * \brief Increments a stat counter
+     * 
+     * Used by front-ends to record statistics
+     * that are not tracked by the backend.
+     * \param [in] ctr The counter to increment
+     * \param [in] val The value to add
+     */
+    void addStatCtr(DxvkStatCounter ctr, uint64_t val) {
+      std::lock_guard<sync::Spinlock> lock(m_statLock);
+      m_statCounters.addCtr(ctr, val);
+    }
 
     /**
      * \brief Retreves current frame ID
@@ -394,6 +484,25 @@ namespace dxvk {
      */
     void waitForIdle();
     
+    /**
+     * \brief Waits until a resource is no longer in use
+     * 
+     * Spins for a short amount of time, and then blocks
+     * the calling thread until the queue thread retires
+     * the last command list that uses the resource.
+     * \param [in] resource The resource to wait for
+     */
+    void waitForResource(const Rc<DxvkResource>& resource);
+    
+    /**
+     * \brief Waits for an event to get signaled
+     * 
+     * Same as \ref waitForResource, but for events. The
+     * event must be tracked by a submitted command list.
+     * \param [in] event The event to wait for
+     */
+    void waitForEvent(const Rc<DxvkEvent>& event);
+    
   private:
     
     DxvkOptions                 m_options;
@@ -414,6 +523,15 @@ namespace dxvk {
     Rc<DxvkMetaMipGenObjects>   m_metaMipGenObjects;
     Rc<DxvkMetaPackObjects>     m_metaPackObjects;
     Rc<DxvkMetaResolveObjects>  m_metaResolveObjects;
+    Rc<DxvkStagingRing>         m_stagingRing;
+    Rc<DxvkImagePacker>         m_imagePacker;
+    Rc<DxvkShaderCache>         m_shaderCache;
+    
+    std::atomic<uint64_t>       m_shaderCodeSize           = { 0ull };
+    std::atomic<uint64_t>       m_shaderCompressedCodeSize = { 0ull };
+    
+    std::mutex                        m_bufferArenaLock;
+    std::vector<Rc<DxvkBufferArena>>  m_bufferArenas;
     
     DxvkUnboundResources        m_unboundResources;
     
@@ -423,8 +541,10 @@ namespace dxvk {
     std::mutex                  m_submissionLock;
     DxvkDeviceQueue             m_graphicsQueue;
     DxvkDeviceQueue             m_presentQueue;
+    DxvkDeviceQueue             m_transferQueue;
     
     DxvkRecycler<DxvkCommandList,    16> m_recycledCommandLists;
+    DxvkRecycler<DxvkCommandList,    16> m_recycledTransferCommandLists;
     DxvkRecycler<DxvkDescriptorPool, 16> m_recycledDescriptorPools;
     DxvkRecycler<DxvkStagingBuffer,   4> m_recycledStagingBuffers;
     
@@ -433,6 +553,9 @@ namespace dxvk {
     void recycleCommandList(
       const Rc<DxvkCommandList>& cmdList);
     
+    template<typename Pred>
+    void waitForCondition(const Pred& pred);
+    
     void recycleDescriptorPool(
       const Rc<DxvkDescriptorPool>& pool);
     
@@ -0,0 +1,165 @@
+#include <algorithm>
+
+#include "dxvk_image_packer.h"
+#include "dxvk_util.h"
+
+namespace dxvk {
+
+  DxvkImagePacker::DxvkImagePacker() {
+    uint32_t numCpuCores = dxvk::thread::hardware_concurrency();
+
+    // Memory bandwidth is saturated very quickly, so
+    // there is little point in using many threads
+    m_workerCount = std::min(MaxWorkerCount, std::max(1u, numCpuCores / 4));
+  }
+
+
+  DxvkImagePacker::~DxvkImagePacker() {
+    { std::lock_guard<std::mutex> lock(m_mutex);
+      m_stopThreads.store(true);
+      m_workerCond.notify_all();
+    }
+
+    for (auto& worker : m_workerThreads)
+      worker.join();
+  }
+
+
+  void DxvkImagePacker::packImageData(
+          char*             dstData,
+    const char*             srcData,
+          VkExtent3D        blockCount,
+          VkDeviceSize      blockSize,
+          VkDeviceSize      pitchPerRow,
+          VkDeviceSize      pitchPerLayer) {
+    const VkDeviceSize bytesPerRow   = blockCount.width  * blockSize;
+    const VkDeviceSize bytesPerLayer = blockCount.height * bytesPerRow;
+    const VkDeviceSize bytesTotal    = blockCount.depth  * bytesPerLayer;
+
+    if (bytesTotal < MinParallelSize) {
+      util::packImageData(dstData, srcData,
+        blockCount, blockSize, pitchPerRow, pitchPerLayer);
+      return;
+    }
+
+    const bool directCopy = ((bytesPerRow   == pitchPerRow  ) || (blockCount.height == 1))
+                         && ((bytesPerLayer == pitchPerLayer) || (blockCount.depth  == 1));
+
+    uint32_t partCount = uint32_t(std::min<VkDeviceSize>(
+      m_workerCount + 1, bytesTotal / MinPartSize));
+
+    std::array<Part, MaxWorkerCount + 1> parts;
+    std::atomic<uint32_t> pending = { partCount - 1 };
+
+    if (directCopy) {
+      // Split the data into cache line aligned chunks,
+      // each of which is treated as a single row
+      VkDeviceSize partSize = align(bytesTotal / partCount, 64);
+
+      for (uint32_t i = 0; i < partCount; i++) {
+        VkDeviceSize offset = partSize * i;
+
+        Part& part = parts[i];
+        part.dstData       = dstData + offset;
+        part.srcData       = srcData + offset;
+        part.bytesPerRow   = i + 1 < partCount ? partSize : bytesTotal - offset;
+        part.rowsPerLayer  = 1;
+        part.pitchPerRow   = part.bytesPerRow;
+        part.pitchPerLayer = part.bytesPerRow;
+        part.rowIndex      = 0;
+        part.rowCount      = 1;
+        part.pending       = &pending;
+      }
+    } else {
+      VkDeviceSize rowsTotal = VkDeviceSize(blockCount.height) * blockCount.depth;
+      VkDeviceSize rowsPerPart = (rowsTotal + partCount - 1) / partCount;
+
+      for (uint32_t i = 0; i < partCount; i++) {
+        VkDeviceSize rowIndex = rowsPerPart * i;
+
+        Part& part = parts[i];
+        part.dstData       = dstData;
+        part.srcData       = srcData;
+        part.bytesPerRow   = bytesPerRow;
+        part.rowsPerLayer  = blockCount.height;
+        part.pitchPerRow   = pitchPerRow;
+        part.pitchPerLayer = pitchPerLayer;
+        part.rowIndex      = std::min(rowIndex, rowsTotal);
+        part.rowCount      = std::min(rowsPerPart, rowsTotal - part.rowIndex);
+        part.pending       = &pending;
+      }
+    }
+
+    { std::lock_guard<std::mutex> lock(m_mutex);
+
+      if (m_workerThreads.empty())
+        this->startWorkers();
+
+      for (uint32_t i = 1; i < partCount; i++)
+        m_queue.push(parts[i]);
+
+      m_workerCond.notify_all();
+    }
+
+    processPart(parts[0]);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    m_doneCond.wait(lock, [&pending] () {
+      return pending.load() == 0;
+    });
+  }
+
+
+  void DxvkImagePacker::startWorkers() {
+    for (uint32_t i = 0; i < m_workerCount; i++)
+      m_workerThreads.emplace_back([this] () { workerFunc(); });
+  }
+
+
+  void DxvkImagePacker::workerFunc() {
+    env::setThreadName(L"dxvk-packer");
+
+    while (!m_stopThreads.load()) {
+      Part part;
+
+      { std::unique_lock<std::mutex> lock(m_mutex);
+
+        m_workerCond.wait(lock, [this] () {
+          return m_queue.size()
+              || m_stopThreads.load();
+        });
+
+        if (m_queue.size() == 0)
+          break;
+
+        part = m_queue.front();
+        m_queue.pop();
+      }
+
+      processPart(part);
+
+      if (part.pending->fetch_sub(1) == 1) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_doneCond.notify_all();
+      }
+    }
+  }
+
+
+  void DxvkImagePacker::processPart(
+    const Part&             part) {
+    for (VkDeviceSize i = 0; i < part.rowCount; i++) {
+      VkDeviceSize rowIndex = part.rowIndex + i;
+
+      VkDeviceSize layer = rowIndex / part.rowsPerLayer;
+      VkDeviceSize row   = rowIndex % part.rowsPerLayer;
+
+      util::streamData(
+        part.dstData + rowIndex * part.bytesPerRow,
+        part.srcData + layer * part.pitchPerLayer + row * part.pitchPerRow,
+        part.bytesPerRow);
+    }
+  }
+
+}
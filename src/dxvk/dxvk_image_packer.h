@@ -0,0 +1,98 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+#include <vector>
+
+#include "../util/thread.h"
+#include "../util/util_env.h"
+
+#include "dxvk_include.h"
+
+namespace dxvk {
+
+  /**
+   * \brief Image data packer
+   *
+   * Packs image data into tightly packed staging
+   * memory. Large copies are split into row ranges
+   * which are processed by a small pool of worker
+   * threads, while the calling thread processes one
+   * of the ranges itself and waits for the rest.
+   *
+   * Worker threads are only created once the first
+   * large copy is performed, so applications which
+   * only upload small images do not pay for them.
+   */
+  class DxvkImagePacker : public RcObject {
+
+  public:
+
+    DxvkImagePacker();
+    ~DxvkImagePacker();
+
+    /**
+     * \brief Writes tightly packed image data to a buffer
+     *
+     * Behaves like \ref util::packImageData, but may
+     * distribute the copy across multiple threads.
+     * \param [in] dstData Destination buffer pointer
+     * \param [in] srcData Pointer to source data
+     * \param [in] blockCount Number of blocks to copy
+     * \param [in] blockSize Number of bytes per block
+     * \param [in] pitchPerRow Number of bytes between rows
+     * \param [in] pitchPerLayer Number of bytes between layers
+     */
+    void packImageData(
+            char*             dstData,
+      const char*             srcData,
+            VkExtent3D        blockCount,
+            VkDeviceSize      blockSize,
+            VkDeviceSize      pitchPerRow,
+            VkDeviceSize      pitchPerLayer);
+
+  private:
+
+    /// Maximum number of worker threads
+    constexpr static uint32_t     MaxWorkerCount  = 4;
+    /// Copies smaller than this are done on the calling thread
+    constexpr static VkDeviceSize MinParallelSize = 4 << 20;
+    /// Minimum amount of data processed by a single thread
+    constexpr static VkDeviceSize MinPartSize     = 1 << 20;
+
+    struct Part {
+            char*             dstData;
+      const char*             srcData;
+            VkDeviceSize      bytesPerRow;
+            VkDeviceSize      rowsPerLayer;
+            VkDeviceSize      pitchPerRow;
+            VkDeviceSize      pitchPerLayer;
+            VkDeviceSize      rowIndex;
+            VkDeviceSize      rowCount;
+      std::atomic<uint32_t>*  pending;
+    };
+
+    uint32_t                  m_workerCount;
+
+    std::atomic<bool>         m_stopThreads = { false };
+
+    std::mutex                m_mutex;
+    std::condition_variable   m_workerCond;
+    std::condition_variable   m_doneCond;
+    std::queue<Part>          m_queue;
+
+    std::vector<dxvk::thread> m_workerThreads;
+
+    void startWorkers();
+
+    void workerFunc();
+
+    static void processPart(
+      const Part&             part);
+
+  };
+
+}
@@ -2,7 +2,10 @@
 
 namespace dxvk {
   
-  DxvkLifetimeTracker:: DxvkLifetimeTracker() { }
+  DxvkLifetimeTracker::DxvkLifetimeTracker()
+  : m_trackingId(nextTrackingId()) { }
+  
+  
   DxvkLifetimeTracker::~DxvkLifetimeTracker() { }
   
   
@@ -10,6 +13,16 @@ namespace dxvk {
     for (const auto& resource : m_resources)
       resource->release();
     m_resources.clear();
+    
+    // Resources stamped with the old ID must
+    // be tracked again by the next submission
+    m_trackingId = nextTrackingId();
+  }
+  
+  
+  uint64_t DxvkLifetimeTracker::nextTrackingId() {
+    static std::atomic<uint64_t> s_trackingId = { 1ull };
+    return s_trackingId++;
   }
   
 }
\ No newline at end of file
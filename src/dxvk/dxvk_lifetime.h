@@ -13,6 +13,11 @@ namespace dxvk {
    * used to guarantee that resources are not destroyed
    * or otherwise accessed in an unsafe manner until the
    * device has finished using them.
+   * 
+   * Each tracker has a tracking ID which changes on every
+   * reset. Resources are stamped with that ID when they
+   * get tracked, so that tracking the same resource again
+   * within one command list only costs a single compare.
    */
   class DxvkLifetimeTracker {
     
@@ -25,9 +30,11 @@ namespace dxvk {
      * \brief Adds a resource to track
      * \param [in] rc The resource to track
      */
-    void trackResource(Rc<DxvkResource>&& rc) {
-      rc->acquire();
-      m_resources.emplace_back(std::move(rc));
+    void trackResource(DxvkResource* rc) {
+      if (rc->setTrackingId(m_trackingId)) {
+        rc->acquire();
+        m_resources.emplace_back(rc);
+      }
     }
     
     /**
@@ -40,8 +47,11 @@ namespace dxvk {
     
   private:
     
+    uint64_t                      m_trackingId;
     std::vector<Rc<DxvkResource>> m_resources;
     
+    static uint64_t nextTrackingId();
+    
   };
   
 }
\ No newline at end of file
@@ -5,7 +5,12 @@ namespace dxvk {
   DxvkOptions::DxvkOptions(const Config& config) {
     allowMemoryOvercommit = config.getOption<bool>    ("dxvk.allowMemoryOvercommit",  false);
     enableStateCache      = config.getOption<bool>    ("dxvk.enableStateCache",       true);
+    enableShaderCache     = config.getOption<bool>    ("dxvk.enableShaderCache",      true);
+    shaderCacheSize       = config.getOption<int32_t> ("dxvk.shaderCacheSize",        256);
     numCompilerThreads    = config.getOption<int32_t> ("dxvk.numCompilerThreads",     0);
+    stagingRingSize       = config.getOption<int32_t> ("dxvk.stagingRingSize",        32);
+    enableTransferQueue   = config.getOption<bool>    ("dxvk.enableTransferQueue",    false);
+    syncSpinTime          = config.getOption<int32_t> ("dxvk.syncSpinTime",           100);
   }
 
 }
\ No newline at end of file
@@ -15,9 +15,28 @@ namespace dxvk {
     /// Enable state cache
     bool enableStateCache;
 
+    /// Enable persistent shader cache
+    bool enableShaderCache;
+
+    /// Maximum size of the shader
+    /// cache file, in MiB
+    int32_t shaderCacheSize;
+
     /// Number of compiler threads
     /// when using the state cache
     int32_t numCompilerThreads;
+
+    /// Size of the device-wide staging
+    /// ring buffer, in MiB. 0 disables it.
+    int32_t stagingRingSize;
+
+    /// Use a dedicated transfer queue for
+    /// uploading initial resource data
+    bool enableTransferQueue;
+
+    /// Time to spin before blocking when waiting
+    /// for the GPU to release a resource, in us
+    int32_t syncSpinTime;
   };
 
 }
\ No newline at end of file
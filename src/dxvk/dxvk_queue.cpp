@@ -70,6 +70,12 @@ namespace dxvk {
         }
         
         m_submits -= 1;
+        
+        // Wake up threads waiting for resources or events that
+        // were released or signaled by the command list. Taking
+        // the lock ensures that waiters cannot miss the update.
+        { std::lock_guard<std::mutex> lock(m_mutex); }
+        m_condOnComplete.notify_all();
       }
     }
   }
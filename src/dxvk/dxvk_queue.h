@@ -45,6 +45,22 @@ namespace dxvk {
      */
     void submit(const Rc<DxvkCommandList>& cmdList);
     
+    /**
+     * \brief Waits for a condition to become true
+     * 
+     * Blocks the calling thread until the given predicate
+     * returns \c true. The predicate is evaluated again
+     * each time a command list has finished executing,
+     * so it must only depend on state that is updated
+     * when the queue thread retires a command list.
+     * \param [in] pred Predicate to wait for
+     */
+    template<typename Pred>
+    void waitFor(const Pred& pred) {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_condOnComplete.wait(lock, pred);
+    }
+    
   private:
     
     DxvkDevice*             m_device;
@@ -55,6 +71,7 @@ namespace dxvk {
     std::mutex              m_mutex;
     std::condition_variable m_condOnAdd;
     std::condition_variable m_condOnTake;
+    std::condition_variable m_condOnComplete;
     std::queue<Rc<DxvkCommandList>> m_entries;
     dxvk::thread             m_thread;
     
@@ -31,9 +31,50 @@ namespace dxvk {
     void acquire() { m_useCount += 1; }
     void release() { m_useCount -= 1; }
     
+    /**
+     * \brief Stamps resource with a tracking ID
+     * 
+     * Used by lifetime trackers to avoid tracking the
+     * same resource more than once per command list.
+     * Tracking IDs are unique and never reused, so a
+     * matching ID means that the resource has already
+     * been acquired by the tracker that owns the ID.
+     * \param [in] trackingId Tracker's current ID
+     * \returns \c false if the ID was already set
+     */
+    bool setTrackingId(uint64_t trackingId) {
+      if (m_trackingId.load(std::memory_order_relaxed) == trackingId)
+        return false;
+      
+      m_trackingId.store(trackingId, std::memory_order_relaxed);
+      return true;
+    }
+    
+    /**
+     * \brief CS sequence number of last use
+     * 
+     * Sequence number of the last CS chunk that
+     * references the resource, or zero if the
+     * resource has never been used by a CS thread.
+     * \returns Sequence number
+     */
+    uint64_t getCsSequenceNumber() const {
+      return m_csSeq.load(std::memory_order_relaxed);
+    }
+    
+    /**
+     * \brief Sets CS sequence number of last use
+     * \param [in] seq Sequence number
+     */
+    void setCsSequenceNumber(uint64_t seq) {
+      m_csSeq.store(seq, std::memory_order_relaxed);
+    }
+    
   private:
     
-    std::atomic<uint32_t> m_useCount = { 0u };
+    std::atomic<uint32_t> m_useCount   = { 0u };
+    std::atomic<uint64_t> m_trackingId = { 0ull };
+    std::atomic<uint64_t> m_csSeq      = { 0ull };
     
   };
   
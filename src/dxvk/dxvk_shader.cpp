@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <chrono>
+
 #include "dxvk_shader.h"
 
 namespace dxvk {
@@ -38,30 +41,29 @@ namespace dxvk {
   }
 
 
-  DxvkShaderModule::DxvkShaderModule(
-    const Rc<vk::DeviceFn>&     vkd,
-    const Rc<DxvkShader>&       shader,
-    const SpirvCodeBuffer&      code)
-  : m_vkd(vkd), m_shader(shader) {
-    VkShaderModuleCreateInfo info;
-    info.sType    = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-    info.pNext    = nullptr;
-    info.flags    = 0;
-    info.codeSize = code.size();
-    info.pCode    = code.data();
-    
-    if (m_vkd->vkCreateShaderModule(m_vkd->device(),
-          &info, nullptr, &m_module) != VK_SUCCESS)
-      throw DxvkError("DxvkComputePipeline::DxvkComputePipeline: Failed to create shader module");
+  bool DxvkShaderModuleKey::eq(const DxvkShaderModuleKey& other) const {
+    return fsDualSrcBlend == other.fsDualSrcBlend
+        && bindingIds     == other.bindingIds;
   }
   
   
-  DxvkShaderModule::~DxvkShaderModule() {
-    m_vkd->vkDestroyShaderModule(
-      m_vkd->device(), m_module, nullptr);
+  size_t DxvkShaderModuleKey::hash() const {
+    DxvkHashState state;
+    state.add(size_t(fsDualSrcBlend));
+    
+    for (uint32_t id : bindingIds)
+      state.add(id);
+    
+    return state;
   }
   
   
+  DxvkShaderModule::DxvkShaderModule(
+    const Rc<DxvkShader>&       shader,
+          VkShaderModule        module)
+  : m_shader(shader), m_module(module) { }
+  
+  
   VkPipelineShaderStageCreateInfo DxvkShaderModule::stageInfo(const VkSpecializationInfo* specInfo) const {
     VkPipelineShaderStageCreateInfo info;
     info.sType                = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
@@ -91,13 +93,20 @@ namespace dxvk {
     
     // Gather the offsets where the binding IDs
     // are stored so we can quickly remap them.
+    // We also need the original IDs and the
+    // capabilities since the code is compressed.
     uint32_t o1VarId = 0;
     
-    for (auto ins : m_code) {
+    for (auto ins : SpirvCodeBuffer(code)) {
+      if (ins.opCode() == spv::OpCapability)
+        m_capabilities.push_back(spv::Capability(ins.arg(1)));
+      
       if (ins.opCode() == spv::OpDecorate) {
         if (ins.arg(2) == spv::DecorationBinding
-         || ins.arg(2) == spv::DecorationSpecId)
+         || ins.arg(2) == spv::DecorationSpecId) {
           m_idOffsets.push_back(ins.offset() + 3);
+          m_idValues.push_back(ins.arg(3));
+        }
         
         if (ins.arg(2) == spv::DecorationLocation && ins.arg(3) == 1) {
           m_o1LocOffset = ins.offset() + 3;
@@ -112,21 +121,14 @@ namespace dxvk {
   
   
   DxvkShader::~DxvkShader() {
-    
+    for (const auto& module : m_modules)
+      m_vkd->vkDestroyShaderModule(m_vkd->device(), module.second, nullptr);
   }
   
   
-  bool DxvkShader::hasCapability(spv::Capability cap) {
-    for (auto ins : m_code) {
-      // OpCapability instructions come first
-      if (ins.opCode() != spv::OpCapability)
-        return false;
-      
-      if (ins.arg(1) == cap)
-        return true;
-    }
-    
-    return false;
+  bool DxvkShader::hasCapability(spv::Capability cap) const {
+    return std::find(m_capabilities.begin(),
+      m_capabilities.end(), cap) != m_capabilities.end();
   }
   
   
@@ -141,26 +143,140 @@ namespace dxvk {
     const Rc<vk::DeviceFn>&          vkd,
     const DxvkDescriptorSlotMapping& mapping,
     const DxvkShaderModuleCreateInfo& info) {
-    SpirvCodeBuffer spirvCode = m_code;
-    uint32_t* code = spirvCode.data();
+    // The patched code only depends on the binding IDs
+    // of the slots used by this shader, so pipelines with
+    // different layouts can often use the same module
+    DxvkShaderModuleKey key;
+    key.bindingIds.reserve(m_idOffsets.size());
+    key.fsDualSrcBlend = info.fsDualSrcBlend
+      && m_o1IdxOffset && m_o1LocOffset;
     
-    // Remap resource binding IDs
-    for (uint32_t ofs : m_idOffsets) {
-      if (code[ofs] < MaxNumResourceSlots)
-        code[ofs] = mapping.getBindingId(code[ofs]);
+    for (uint32_t id : m_idValues) {
+      key.bindingIds.push_back(id < MaxNumResourceSlots
+        ? mapping.getBindingId(id)
+        : id);
     }
-
+    
+    std::lock_guard<std::mutex> lock(m_moduleMutex);
+    
+    auto entry = m_modules.find(key);
+    
+    if (entry != m_modules.end())
+      return new DxvkShaderModule(this, entry->second);
+    
+    auto t0 = std::chrono::high_resolution_clock::now();
+    SpirvCodeBuffer spirvCode = m_code.decompress();
+    auto t1 = std::chrono::high_resolution_clock::now();
+    auto td = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0);
+    
+    Logger::debug(str::format("DxvkShader: Decompressed ", debugName(), ": ",
+      m_code.size(), " -> ", spirvCode.size(), " bytes in ", td.count(), " us"));
+    
+    // Remap resource binding IDs
+    uint32_t* code = spirvCode.data();
+    
+    for (size_t i = 0; i < m_idOffsets.size(); i++)
+      code[m_idOffsets[i]] = key.bindingIds[i];
+    
     // For dual-source blending we need to re-map
     // location 1, index 0 to location 0, index 1
-    if (info.fsDualSrcBlend && m_o1IdxOffset && m_o1LocOffset)
+    if (key.fsDualSrcBlend)
       std::swap(code[m_o1IdxOffset], code[m_o1LocOffset]);
     
-    return new DxvkShaderModule(vkd, this, spirvCode);
+    VkShaderModuleCreateInfo moduleInfo;
+    moduleInfo.sType    = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    moduleInfo.pNext    = nullptr;
+    moduleInfo.flags    = 0;
+    moduleInfo.codeSize = spirvCode.size();
+    moduleInfo.pCode    = spirvCode.data();
+    
+    VkShaderModule module = VK_NULL_HANDLE;
+    
+    if (vkd->vkCreateShaderModule(vkd->device(),
+          &moduleInfo, nullptr, &module) != VK_SUCCESS)
+      throw DxvkError("DxvkShader::createShaderModule: Failed to create shader module");
+    
+    m_vkd = vkd;
+    m_modules.insert({ std::move(key), module });
+    return new DxvkShaderModule(this, module);
   }
   
   
   void DxvkShader::dump(std::ostream& outputStream) const {
-    m_code.store(outputStream);
+    m_code.decompress().store(outputStream);
+  }
+  
+  
+  void DxvkShader::write(std::ostream& outputStream) const {
+    auto writeData = [&outputStream] (const void* data, size_t size) {
+      outputStream.write(reinterpret_cast<const char*>(data), size);
+    };
+    
+    uint32_t stage     = uint32_t(m_stage);
+    uint32_t slotCount = uint32_t(m_slots.size());
+    uint32_t constSize = uint32_t(m_constData.sizeInBytes());
+    SpirvCodeBuffer code = m_code.decompress();
+    
+    uint32_t codeSize  = uint32_t(code.size());
+    
+    writeData(&stage,     sizeof(stage));
+    writeData(&slotCount, sizeof(slotCount));
+    writeData(m_slots.data(), sizeof(DxvkResourceSlot) * slotCount);
+    writeData(&m_interface, sizeof(m_interface));
+    writeData(&m_options,   sizeof(m_options));
+    writeData(&constSize, sizeof(constSize));
+    writeData(m_constData.data(), constSize);
+    writeData(&codeSize,  sizeof(codeSize));
+    writeData(code.data(), codeSize);
+  }
+  
+  
+  Rc<DxvkShader> DxvkShader::read(std::istream& inputStream) {
+    auto readData = [&inputStream] (void* data, size_t size) {
+      return bool(inputStream.read(reinterpret_cast<char*>(data), size));
+    };
+    
+    uint32_t stage     = 0;
+    uint32_t slotCount = 0;
+    uint32_t constSize = 0;
+    uint32_t codeSize  = 0;
+    
+    DxvkInterfaceSlots iface;
+    DxvkShaderOptions  options;
+    
+    if (!readData(&stage,     sizeof(stage))
+     || !readData(&slotCount, sizeof(slotCount))
+     || slotCount > MaxNumResourceSlots)
+      return nullptr;
+    
+    std::vector<DxvkResourceSlot> slots(slotCount);
+    
+    if (!readData(slots.data(), sizeof(DxvkResourceSlot) * slotCount)
+     || !readData(&iface,     sizeof(iface))
+     || !readData(&options,   sizeof(options))
+     || !readData(&constSize, sizeof(constSize))
+     || (constSize % sizeof(uint32_t)))
+      return nullptr;
+    
+    std::vector<uint32_t> constData(constSize / sizeof(uint32_t));
+    
+    if (!readData(constData.data(), constSize)
+     || !readData(&codeSize, sizeof(codeSize))
+     || (codeSize % sizeof(uint32_t)))
+      return nullptr;
+    
+    std::vector<uint32_t> code(codeSize / sizeof(uint32_t));
+    
+    if (!readData(code.data(), codeSize))
+      return nullptr;
+    
+    return new DxvkShader(
+      VkShaderStageFlagBits(stage),
+      slots.size(), slots.data(), iface,
+      SpirvCodeBuffer(code.size(), code.data()),
+      options, constData.size()
+        ? DxvkShaderConstData(constData.size(), constData.data())
+        : DxvkShaderConstData());
   }
   
 }
\ No newline at end of file
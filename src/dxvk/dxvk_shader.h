@@ -1,13 +1,17 @@
 #pragma once
 
+#include <mutex>
+#include <unordered_map>
 #include <vector>
 
+#include "dxvk_hash.h"
 #include "dxvk_include.h"
 #include "dxvk_limits.h"
 #include "dxvk_pipelayout.h"
 #include "dxvk_shader_key.h"
 
 #include "../spirv/spirv_code_buffer.h"
+#include "../spirv/spirv_compression.h"
 
 namespace dxvk {
   
@@ -111,6 +115,24 @@ namespace dxvk {
   };
   
   
+  /**
+   * \brief Shader module key
+   * 
+   * Stores the binding IDs that the shader's resource
+   * slots get mapped to, as well as any other state
+   * that affects the patched SPIR-V code. Pipelines
+   * with matching keys can share a shader module.
+   */
+  struct DxvkShaderModuleKey {
+    std::vector<uint32_t> bindingIds;
+    bool                  fsDualSrcBlend;
+    
+    bool eq(const DxvkShaderModuleKey& other) const;
+    
+    size_t hash() const;
+  };
+  
+  
   /**
    * \brief Shader object
    * 
@@ -152,7 +174,7 @@ namespace dxvk {
      * \param [in] cap The capability to check
      * \returns \c true if \c cap is enabled
      */
-    bool hasCapability(spv::Capability cap);
+    bool hasCapability(spv::Capability cap) const;
     
     /**
      * \brief Adds resource slots definitions to a mapping
@@ -167,7 +189,10 @@ namespace dxvk {
     /**
      * \brief Creates a shader module
      * 
-     * Maps the binding slot numbers 
+     * Maps the binding slot numbers. Vulkan shader
+     * modules are cached, so that pipelines using
+     * the same binding layout for this shader do
+     * not have to patch and create them again.
      * \param [in] vkd Vulkan device functions
      * \param [in] mapping Resource slot mapping
      * \param [in] info Module create info
@@ -209,6 +234,26 @@ namespace dxvk {
       return m_constData;
     }
     
+    /**
+     * \brief Uncompressed code size
+     * \returns Code size, in bytes
+     */
+    size_t codeSize() const {
+      return m_code.dwords() * sizeof(uint32_t);
+    }
+    
+    /**
+     * \brief Compressed code size
+     * 
+     * The SPIR-V code is kept in a compressed form
+     * and only decompressed when it is needed to
+     * create a shader module.
+     * \returns Compressed code size, in bytes
+     */
+    size_t compressedCodeSize() const {
+      return m_code.size();
+    }
+    
     /**
      * \brief Dumps SPIR-V shader
      * 
@@ -217,6 +262,24 @@ namespace dxvk {
      */
     void dump(std::ostream& outputStream) const;
     
+    /**
+     * \brief Serializes the shader
+     * 
+     * Writes the SPIR-V code along with all the metadata
+     * required to recreate the shader object, except for
+     * the shader key, which has to be set by the caller.
+     * \param [in] outputStream Stream to write to
+     */
+    void write(std::ostream& outputStream) const;
+    
+    /**
+     * \brief Deserializes a shader
+     * 
+     * \param [in] inputStream Stream to read from
+     * \returns The shader, or \c nullptr on error
+     */
+    static Rc<DxvkShader> read(std::istream& inputStream);
+    
     /**
      * \brief Sets the shader key
      * \param [in] key Unique key
@@ -244,10 +307,12 @@ namespace dxvk {
   private:
     
     VkShaderStageFlagBits m_stage;
-    SpirvCodeBuffer       m_code;
+    SpirvCompressedBuffer m_code;
     
     std::vector<DxvkResourceSlot> m_slots;
     std::vector<size_t>           m_idOffsets;
+    std::vector<uint32_t>         m_idValues;
+    std::vector<spv::Capability>  m_capabilities;
     DxvkInterfaceSlots            m_interface;
     DxvkShaderOptions             m_options;
     DxvkShaderConstData           m_constData;
@@ -256,27 +321,33 @@ namespace dxvk {
     size_t m_o1IdxOffset = 0;
     size_t m_o1LocOffset = 0;
     
+    std::mutex                    m_moduleMutex;
+    Rc<vk::DeviceFn>              m_vkd;
+    
+    std::unordered_map<
+      DxvkShaderModuleKey,
+      VkShaderModule,
+      DxvkHash, DxvkEq>           m_modules;
+    
   };
   
 
   /**
    * \brief Shader module object
    * 
-   * Manages a Vulkan shader module. This will not
+   * References a Vulkan shader module. This will not
    * perform any shader compilation. Instead, the
    * context will create pipeline objects on the
-   * fly when executing draw calls.
+   * fly when executing draw calls. The Vulkan
+   * module itself is owned by the shader.
    */
   class DxvkShaderModule : public RcObject {
     
   public:
     
     DxvkShaderModule(
-      const Rc<vk::DeviceFn>&     vkd,
       const Rc<DxvkShader>&       shader,
-      const SpirvCodeBuffer&      code);
-    
-    ~DxvkShaderModule();
+            VkShaderModule        module);
     
     /**
      * \brief Shader module handle
@@ -313,7 +384,6 @@ namespace dxvk {
     
   private:
     
-    Rc<vk::DeviceFn>      m_vkd;
     Rc<DxvkShader>        m_shader;
     VkShaderModule        m_module;
     
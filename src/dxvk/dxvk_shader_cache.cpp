@@ -0,0 +1,241 @@
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+#include <version.h>
+
+#include "dxvk_shader_cache.h"
+
+namespace dxvk {
+
+  DxvkShaderCache::DxvkShaderCache(
+    const DxvkOptions&          options)
+  : m_buildId     (Sha1Hash::compute(DXVK_VERSION, std::strlen(DXVK_VERSION))),
+    m_maxFileSize (size_t(std::max(options.shaderCacheSize, 1)) << 20) {
+    if (!readCacheFile())
+      writeCacheFile();
+
+    m_file = std::ofstream(getCacheFileName(),
+      std::ios_base::binary |
+      std::ios_base::app);
+  }
+
+
+  DxvkShaderCache::~DxvkShaderCache() {
+    Logger::info(str::format(
+      "DXVK: Shader cache: ", m_hits.load(), " hits, ",
+      m_misses.load(), " misses"));
+  }
+
+
+  Rc<DxvkShader> DxvkShaderCache::lookup(
+    const Sha1Hash&             key) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto entry = m_entries.find(key);
+
+    if (entry != m_entries.end()) {
+      std::istringstream stream(entry->second.data);
+      Rc<DxvkShader> shader = DxvkShader::read(stream);
+
+      if (shader != nullptr) {
+        m_hits += 1;
+        return shader;
+      }
+
+      // Don't try to read broken entries again
+      m_entries.erase(entry);
+    }
+
+    m_misses += 1;
+    return nullptr;
+  }
+
+
+  void DxvkShaderCache::add(
+    const Sha1Hash&             key,
+    const Rc<DxvkShader>&       shader) {
+    std::ostringstream stream;
+    shader->write(stream);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto entry = m_entries.insert({ key, { stream.str(), m_nextOrder } });
+
+    if (!entry.second)
+      return;
+
+    m_nextOrder += 1;
+
+    // Entries that do not fit into the file anymore are
+    // only kept in memory. The file will be compacted
+    // the next time the cache is loaded.
+    size_t entrySize = sizeof(DxvkShaderCacheEntryHeader)
+                     + entry.first->second.data.size();
+
+    if (m_fileSize + entrySize > m_maxFileSize)
+      return;
+
+    writeCacheEntry(m_file, key, entry.first->second.data);
+    m_file.flush();
+
+    m_fileSize += entrySize;
+  }
+
+
+  bool DxvkShaderCache::readCacheFile() {
+    std::ifstream ifile(getCacheFileName(), std::ios_base::binary);
+
+    if (!ifile) {
+      Logger::warn("DXVK: No shader cache file found");
+      return false;
+    }
+
+    DxvkShaderCacheHeader expected;
+    expected.buildId = m_buildId;
+
+    DxvkShaderCacheHeader actual;
+
+    if (!ifile.read(reinterpret_cast<char*>(&actual), sizeof(actual))
+     || std::memcmp(expected.magic, actual.magic, sizeof(expected.magic))
+     || expected.version != actual.version
+     || !(expected.buildId == actual.buildId)) {
+      Logger::warn("DXVK: Shader cache out of date");
+      return false;
+    }
+
+    // Read all entries. Since entries are variable in size,
+    // we have to stop at the first entry which is truncated.
+    uint32_t numInvalidEntries = 0;
+    size_t   fileSize          = sizeof(actual);
+
+    while (ifile) {
+      DxvkShaderCacheEntryHeader header;
+
+      if (!ifile.read(reinterpret_cast<char*>(&header), sizeof(header)))
+        break;
+
+      if (header.size > m_maxFileSize) {
+        numInvalidEntries += 1;
+        break;
+      }
+
+      std::string data(header.size, '\0');
+
+      if (!ifile.read(&data[0], data.size())) {
+        numInvalidEntries += 1;
+        break;
+      }
+
+      if (!(Sha1Hash::compute(data.data(), data.size()) == header.checksum)
+       || !m_entries.insert({ header.key, { std::move(data), m_nextOrder } }).second) {
+        numInvalidEntries += 1;
+        continue;
+      }
+
+      m_nextOrder += 1;
+      fileSize += sizeof(header) + header.size;
+    }
+
+    Logger::info(str::format(
+      "DXVK: Read ", m_entries.size(),
+      " valid shader cache entries"));
+
+    if (numInvalidEntries) {
+      Logger::warn(str::format(
+        "DXVK: Skipped ", numInvalidEntries,
+        " invalid shader cache entries"));
+    }
+
+    // Drop the oldest entries if the file has grown too
+    // large, leaving some room for newly compiled shaders
+    bool trimEntries = fileSize > m_maxFileSize;
+
+    if (trimEntries) {
+      std::vector<std::pair<uint64_t, Sha1Hash>> order;
+      order.reserve(m_entries.size());
+
+      for (const auto& e : m_entries)
+        order.push_back({ e.second.order, e.first });
+
+      std::sort(order.begin(), order.end(),
+        [] (const auto& a, const auto& b) { return a.first < b.first; });
+
+      size_t entryCount = m_entries.size();
+
+      for (size_t i = 0; i < order.size() && fileSize > m_maxFileSize / 4 * 3; i++) {
+        auto e = m_entries.find(order[i].second);
+        fileSize -= sizeof(DxvkShaderCacheEntryHeader) + e->second.data.size();
+        m_entries.erase(e);
+      }
+
+      Logger::info(str::format(
+        "DXVK: Removed ", entryCount - m_entries.size(),
+        " shader cache entries"));
+    }
+
+    m_fileSize = fileSize;
+    return !numInvalidEntries && !trimEntries;
+  }
+
+
+  void DxvkShaderCache::writeCacheFile() {
+    std::ofstream file(getCacheFileName(),
+      std::ios_base::binary |
+      std::ios_base::trunc);
+
+    DxvkShaderCacheHeader header;
+    header.buildId = m_buildId;
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    m_fileSize = sizeof(header);
+
+    // Write back all valid entries in their original
+    // order in case we're compacting an existing file
+    std::vector<const std::pair<const Sha1Hash, Entry>*> entries;
+    entries.reserve(m_entries.size());
+
+    for (const auto& e : m_entries)
+      entries.push_back(&e);
+
+    std::sort(entries.begin(), entries.end(),
+      [] (const auto* a, const auto* b) { return a->second.order < b->second.order; });
+
+    for (const auto* e : entries) {
+      writeCacheEntry(file, e->first, e->second.data);
+      m_fileSize += sizeof(DxvkShaderCacheEntryHeader) + e->second.data.size();
+    }
+  }
+
+
+  void DxvkShaderCache::writeCacheEntry(
+          std::ostream&         stream,
+    const Sha1Hash&             key,
+    const std::string&          data) {
+    DxvkShaderCacheEntryHeader header;
+    header.key      = key;
+    header.checksum = Sha1Hash::compute(data.data(), data.size());
+    header.size     = uint32_t(data.size());
+
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    stream.write(data.data(), data.size());
+  }
+
+
+  std::string DxvkShaderCache::getCacheFileName() const {
+    std::string path = env::getEnvVar("DXVK_STATE_CACHE_PATH");
+
+    if (!path.empty() && *path.rbegin() != '/')
+      path += '/';
+
+    std::string exeName = env::getExeName();
+    auto extp = exeName.find_last_of('.');
+
+    if (extp != std::string::npos && exeName.substr(extp + 1) == "exe")
+      exeName.erase(extp);
+
+    path += exeName + ".dxvk-shaders";
+    return path;
+  }
+
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <atomic>
+#include <fstream>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "../util/sha1/sha1_util.h"
+
+#include "dxvk_options.h"
+#include "dxvk_shader.h"
+
+namespace dxvk {
+
+  /**
+   * \brief Shader cache header
+   *
+   * Stores the cache format version as well as a hash of the
+   * DXVK version string. Since the generated code may change
+   * between versions, a mismatch invalidates the whole file.
+   */
+  struct DxvkShaderCacheHeader {
+    char     magic[4]   = { 'D', 'X', 'S', 'C' };
+    uint32_t version    = 1;
+    Sha1Hash buildId;
+  };
+
+  static_assert(sizeof(DxvkShaderCacheHeader) == 28);
+
+
+  /**
+   * \brief Shader cache entry header
+   *
+   * Precedes the serialized shader data in the cache
+   * file. The checksum is computed from the data and
+   * used to detect corrupted entries.
+   */
+  struct DxvkShaderCacheEntryHeader {
+    Sha1Hash key;
+    Sha1Hash checksum;
+    uint32_t size;
+  };
+
+  static_assert(sizeof(DxvkShaderCacheEntryHeader) == 44);
+
+
+  /**
+   * \brief Shader cache
+   *
+   * Persistent cache for compiled shaders, so that the client
+   * API does not have to recompile every shader on startup.
+   * Lookups use a key computed by the client API, which must
+   * cover everything that affects the generated code.
+   *
+   * All entries are read when the cache is created. New
+   * entries are appended to the file as long as it stays
+   * within the configured size limit. If the file contains
+   * invalid or duplicate entries or exceeds the limit, it
+   * is compacted, keeping the most recently added entries.
+   */
+  class DxvkShaderCache : public RcObject {
+
+  public:
+
+    DxvkShaderCache(
+      const DxvkOptions&          options);
+
+    ~DxvkShaderCache();
+
+    /**
+     * \brief Looks up a shader
+     *
+     * \param [in] key Shader cache key
+     * \returns The shader, or \c nullptr if
+     *    the shader is not in the cache
+     */
+    Rc<DxvkShader> lookup(
+      const Sha1Hash&             key);
+
+    /**
+     * \brief Adds a shader to the cache
+     *
+     * \param [in] key Shader cache key
+     * \param [in] shader The shader to add
+     */
+    void add(
+      const Sha1Hash&             key,
+      const Rc<DxvkShader>&       shader);
+
+  private:
+
+    struct KeyHash {
+      size_t operator () (const Sha1Hash& key) const {
+        return key.dword(0);
+      }
+    };
+
+    struct Entry {
+      std::string     data;
+      uint64_t        order;
+    };
+
+    std::mutex        m_mutex;
+    Sha1Hash          m_buildId;
+    size_t            m_maxFileSize;
+    size_t            m_fileSize = 0;
+    uint64_t          m_nextOrder = 0;
+    std::ofstream     m_file;
+
+    std::unordered_map<Sha1Hash, Entry, KeyHash> m_entries;
+
+    std::atomic<uint32_t> m_hits   = { 0u };
+    std::atomic<uint32_t> m_misses = { 0u };
+
+    bool readCacheFile();
+
+    void writeCacheFile();
+
+    void writeCacheEntry(
+            std::ostream&         stream,
+      const Sha1Hash&             key,
+      const std::string&          data);
+
+    std::string getCacheFileName() const;
+
+  };
+
+}
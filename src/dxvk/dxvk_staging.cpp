@@ -1,3 +1,5 @@
+#include <chrono>
+
 #include "dxvk_device.h"
 #include "dxvk_staging.h"
 
@@ -48,6 +50,148 @@ namespace dxvk {
   }
   
   
+  DxvkStagingRing::DxvkStagingRing(
+          DxvkDevice*             device,
+          VkDeviceSize            size)
+  : m_device(device), m_size(align(size, 256)) {
+    DxvkBufferCreateInfo info;
+    info.size   = m_size;
+    info.usage  = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    info.stages = VK_PIPELINE_STAGE_TRANSFER_BIT
+                | VK_PIPELINE_STAGE_HOST_BIT;
+    info.access = VK_ACCESS_TRANSFER_READ_BIT
+                | VK_ACCESS_HOST_WRITE_BIT;
+    
+    VkMemoryPropertyFlags memFlags
+      = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+      | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    
+    m_buffer = device->createBuffer(info, memFlags);
+  }
+  
+  
+  DxvkStagingRing::~DxvkStagingRing() {
+    
+  }
+  
+  
+  bool DxvkStagingRing::alloc(
+    const void*                   owner,
+          VkDeviceSize            size,
+          DxvkStagingBufferSlice& slice,
+          uint64_t&               blockId) {
+    size = align(size, 64);
+    
+    std::unique_lock<std::mutex> lock(m_mutex);
+    
+    if (size > m_size) {
+      m_stats.fallbackCount += 1;
+      return false;
+    }
+    
+    VkDeviceSize offset = 0;
+    
+    if (!this->tryAlloc(owner, size, offset)) {
+      auto t0 = std::chrono::high_resolution_clock::now();
+      
+      bool success = false;
+      bool waited  = false;
+      
+      // Wait for other command lists to return their memory.
+      // If the oldest block belongs to a command list that has
+      // not been submitted yet, which includes our own, or if
+      // the GPU is idle, nothing will be freed soon, so give up.
+      while (!success) {
+        if (m_blocks.empty()
+         || m_blocks.front().owner == owner
+         || !m_blocks.front().submitted
+         || m_device->pendingSubmissions() == 0)
+          break;
+        
+        m_cond.wait_for(lock, std::chrono::milliseconds(1));
+        success = this->tryAlloc(owner, size, offset);
+        waited  = true;
+      }
+      
+      if (waited) {
+        auto t1 = std::chrono::high_resolution_clock::now();
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0);
+        
+        m_stats.stallCount  += 1;
+        m_stats.stallTimeUs += us.count();
+      }
+      
+      if (!success) {
+        m_stats.fallbackCount += 1;
+        return false;
+      }
+    }
+    
+    auto physicalSlice = m_buffer->subSlice(offset, size);
+    slice.buffer = physicalSlice.handle();
+    slice.offset = physicalSlice.offset();
+    slice.mapPtr = physicalSlice.mapPtr(0);
+    
+    blockId = m_blockId + m_blocks.size() - 1;
+    return true;
+  }
+  
+  
+  void DxvkStagingRing::submit(uint64_t blockId) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_blocks.at(blockId - m_blockId).submitted = true;
+  }
+  
+  
+  void DxvkStagingRing::free(uint64_t blockId) {
+    { std::lock_guard<std::mutex> lock(m_mutex);
+      
+      m_blocks.at(blockId - m_blockId).freed = true;
+      
+      // Memory can only be reclaimed in allocation
+      // order, so advance the tail as far as possible
+      while (!m_blocks.empty() && m_blocks.front().freed) {
+        m_tail = m_blocks.front().end;
+        m_blocks.pop_front();
+        m_blockId += 1;
+      }
+    }
+    
+    m_cond.notify_all();
+  }
+  
+  
+  DxvkStagingRingStats DxvkStagingRing::getStats() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+  }
+  
+  
+  bool DxvkStagingRing::tryAlloc(
+    const void*                   owner,
+          VkDeviceSize            size,
+          VkDeviceSize&           offset) {
+    // Restart at the beginning of the buffer if the
+    // ring is empty in order to reduce fragmentation
+    if (m_blocks.empty())
+      m_head = m_tail = 0;
+    
+    // Allocations must not wrap around the end of the
+    // buffer, so skip the remaining space if necessary
+    VkDeviceSize head = m_head % m_size;
+    VkDeviceSize skip = head + size > m_size ? m_size - head : 0;
+    
+    if (m_head + skip + size - m_tail > m_size)
+      return false;
+    
+    offset  = skip ? 0 : head;
+    m_head += skip + size;
+    
+    m_blocks.push_back({ m_head, owner, false, false });
+    return true;
+  }
+  
+  
   DxvkStagingAlloc::DxvkStagingAlloc(DxvkDevice* device)
   : m_device(device) { }
   
@@ -58,6 +202,22 @@ namespace dxvk {
   
   
   DxvkStagingBufferSlice DxvkStagingAlloc::alloc(VkDeviceSize size) {
+    DxvkStagingBufferSlice slice;
+    
+    // Serve the allocation from the device-wide staging
+    // ring if possible. This avoids holding on to entire
+    // staging buffers for the lifetime of a command list.
+    DxvkStagingRing* ring = m_device->stagingRing();
+    
+    if (ring != nullptr) {
+      uint64_t blockId = 0;
+      
+      if (ring->alloc(this, size, slice, blockId)) {
+        m_ringBlocks.push_back(blockId);
+        return slice;
+      }
+    }
+    
     Rc<DxvkStagingBuffer> selectedBuffer;
     
     // Try a worst-fit allocation strategy on the existing staging
@@ -71,8 +231,6 @@ namespace dxvk {
     // If we have no suitable buffer, allocate one from the device
     // that is *at least* as large as the amount of data we need
     // to upload. Usually it will be bigger.
-    DxvkStagingBufferSlice slice;
-    
     if ((selectedBuffer == nullptr) || (!selectedBuffer->alloc(size, slice))) {
       selectedBuffer = m_device->allocStagingBuffer(size);
       selectedBuffer->alloc(size, slice);
@@ -83,11 +241,30 @@ namespace dxvk {
   }
   
   
+  void DxvkStagingAlloc::submit() {
+    if (!m_ringBlocks.empty()) {
+      DxvkStagingRing* ring = m_device->stagingRing();
+      
+      for (uint64_t blockId : m_ringBlocks)
+        ring->submit(blockId);
+    }
+  }
+  
+  
   void DxvkStagingAlloc::reset() {
     for (const auto& buf : m_stagingBuffers)
       m_device->recycleStagingBuffer(buf);
     
     m_stagingBuffers.resize(0);
+    
+    if (!m_ringBlocks.empty()) {
+      DxvkStagingRing* ring = m_device->stagingRing();
+      
+      for (uint64_t blockId : m_ringBlocks)
+        ring->free(blockId);
+      
+      m_ringBlocks.resize(0);
+    }
   }
   
 }
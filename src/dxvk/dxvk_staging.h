@@ -1,5 +1,9 @@
 #pragma once
 
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
 #include "dxvk_buffer.h"
 
 namespace dxvk {
@@ -78,11 +82,129 @@ namespace dxvk {
   };
   
   
+  /**
+   * \brief Staging ring statistics
+   */
+  struct DxvkStagingRingStats {
+    uint64_t stallCount    = 0;
+    uint64_t stallTimeUs   = 0;
+    uint64_t fallbackCount = 0;
+  };
+  
+  
+  /**
+   * \brief Staging ring
+   * 
+   * Device-wide, persistently mapped ring buffer that serves
+   * staging allocations for all command lists. Allocations
+   * are returned to the ring once the command list that owns
+   * them has finished execution on the GPU, and memory is
+   * reclaimed in allocation order. Command lists may complete
+   * out of order, so each allocation is tracked as a block.
+   */
+  class DxvkStagingRing : public RcObject {
+    
+  public:
+    
+    DxvkStagingRing(
+            DxvkDevice*             device,
+            VkDeviceSize            size);
+    ~DxvkStagingRing();
+    
+    /**
+     * \brief Ring buffer size, in bytes
+     * \returns Ring buffer size, in bytes
+     */
+    VkDeviceSize size() const {
+      return m_size;
+    }
+    
+    /**
+     * \brief Allocates a staging buffer slice
+     * 
+     * If the ring is full, this will wait for other
+     * command lists to complete execution, unless the
+     * oldest allocation belongs to a command list that
+     * has not been submitted yet. Fails
+     * if no memory could be made available, in which
+     * case the caller should fall back to a dedicated
+     * staging buffer.
+     * \param [in] owner Allocating staging allocator
+     * \param [in] size Requested allocation size
+     * \param [out] slice Allocated staging buffer slice
+     * \param [out] blockId Block ID, used to free the slice
+     * \returns \c true on success, \c false on failure
+     */
+    bool alloc(
+      const void*                   owner,
+            VkDeviceSize            size,
+            DxvkStagingBufferSlice& slice,
+            uint64_t&               blockId);
+    
+    /**
+     * \brief Marks a block as submitted
+     * 
+     * Must be called once the command list that
+     * allocated the block has been submitted, so
+     * that other command lists can wait for it.
+     * \param [in] blockId Block ID
+     */
+    void submit(uint64_t blockId);
+    
+    /**
+     * \brief Frees an allocated block
+     * 
+     * Must only be called once the GPU has finished
+     * using the block, i.e. when the command list
+     * that allocated it is being reset.
+     * \param [in] blockId Block ID
+     */
+    void free(uint64_t blockId);
+    
+    /**
+     * \brief Retrieves ring statistics
+     * \returns Stall and fallback counters
+     */
+    DxvkStagingRingStats getStats();
+    
+  private:
+    
+    struct Block {
+      uint64_t    end;
+      const void* owner;
+      bool        submitted;
+      bool        freed;
+    };
+    
+    DxvkDevice*             m_device;
+    Rc<DxvkBuffer>          m_buffer;
+    VkDeviceSize            m_size;
+    
+    std::mutex              m_mutex;
+    std::condition_variable m_cond;
+    
+    uint64_t                m_head    = 0;
+    uint64_t                m_tail    = 0;
+    uint64_t                m_blockId = 0;
+    std::deque<Block>       m_blocks;
+    
+    DxvkStagingRingStats    m_stats;
+    
+    bool tryAlloc(
+      const void*                   owner,
+            VkDeviceSize            size,
+            VkDeviceSize&           offset);
+    
+  };
+  
+  
   /**
    * \brief Staging buffer allocator
    * 
-   * Convenient allocator for staging buffer slices
-   * which creates new staging buffers on demand.
+   * Convenient allocator for staging buffer slices.
+   * Allocates from the device's staging ring if
+   * possible, and creates new staging buffers on
+   * demand otherwise.
    */
   class DxvkStagingAlloc {
     
@@ -102,6 +224,14 @@ namespace dxvk {
     DxvkStagingBufferSlice alloc(
             VkDeviceSize      size);
     
+    /**
+     * \brief Marks ring allocations as submitted
+     * 
+     * Called when the command list that owns
+     * this allocator is submitted to the GPU.
+     */
+    void submit();
+    
     /**
      * \brief Resets staging buffer allocator
      * 
@@ -116,6 +246,7 @@ namespace dxvk {
     DxvkDevice* const m_device;
     
     std::vector<Rc<DxvkStagingBuffer>> m_stagingBuffers;
+    std::vector<uint64_t>              m_ringBlocks;
     
   };
   
@@ -14,6 +14,7 @@ namespace dxvk {
     CmdDrawCalls,             ///< Number of draw calls
     CmdDispatchCalls,         ///< Number of compute calls
     CmdRenderPassCount,       ///< Number of render passes
+    CmdBarrierCount,          ///< Number of pipeline barriers
     MemoryAllocationCount,    ///< Number of memory allocations
     MemoryAllocated,          ///< Amount of memory allocated
     MemoryUsed,               ///< Amount of memory used
@@ -21,6 +22,13 @@ namespace dxvk {
     PipeCountCompute,         ///< Number of compute pipelines
     QueueSubmitCount,         ///< Number of command buffer submissions
     QueuePresentCount,        ///< Number of present calls / frames
+    StagingRingStalls,        ///< Number of staging ring stalls
+    StagingRingStallTime,     ///< Time spent waiting on the staging ring, in us
+    StagingRingFallbacks,     ///< Number of staging allocations not served by the ring
+    SyncWaitCount,            ///< Number of blocking waits for resources or events
+    SyncWaitTime,             ///< Time spent blocking instead of spinning, in us
+    ReadbackStallCount,       ///< Number of image readbacks that had to wait
+    ReadbackStallTime,        ///< Time spent waiting for image readbacks, in us
     NumCounters,              ///< Number of counters available
   };
   
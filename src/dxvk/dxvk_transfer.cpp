@@ -0,0 +1,194 @@
+#include <cstring>
+
+#include "dxvk_device.h"
+#include "dxvk_transfer.h"
+
+namespace dxvk {
+
+  DxvkTransferContext::DxvkTransferContext(DxvkDevice* device)
+  : m_device(device) {
+
+  }
+
+
+  DxvkTransferContext::~DxvkTransferContext() {
+
+  }
+
+
+  void DxvkTransferContext::uploadBuffer(
+    const Rc<DxvkBuffer>&           buffer,
+          VkDeviceSize              offset,
+          VkDeviceSize              size,
+    const void*                     data) {
+    this->beginRecording();
+
+    auto physicalSlice = buffer->subSlice(offset, size);
+
+    auto slice = m_transferCmd->stagedAlloc(size);
+    std::memcpy(slice.mapPtr, data, size);
+
+    m_transferCmd->stagedBufferCopy(
+      physicalSlice.handle(),
+      physicalSlice.offset(),
+      physicalSlice.length(),
+      slice);
+
+    VkBufferMemoryBarrier barrier;
+    barrier.sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    barrier.pNext               = nullptr;
+    barrier.srcAccessMask       = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask       = 0;
+    barrier.srcQueueFamilyIndex = m_device->transferQueue().queueFamily;
+    barrier.dstQueueFamilyIndex = m_device->graphicsQueue().queueFamily;
+    barrier.buffer              = physicalSlice.handle();
+    barrier.offset              = physicalSlice.offset();
+    barrier.size                = physicalSlice.length();
+    m_bufReleases.push_back(barrier);
+
+    barrier.srcAccessMask       = 0;
+    barrier.dstAccessMask       = buffer->info().access;
+    m_bufAcquires.push_back(barrier);
+
+    m_acquireStages |= buffer->info().stages;
+
+    m_transferCmd->trackResource(physicalSlice.resource());
+    m_resources.push_back(physicalSlice.resource());
+  }
+
+
+  void DxvkTransferContext::uploadImage(
+    const Rc<DxvkImage>&            image,
+    const VkImageSubresourceLayers& subresources,
+    const void*                     data,
+          VkDeviceSize              pitchPerRow,
+          VkDeviceSize              pitchPerLayer) {
+    this->beginRecording();
+
+    const DxvkFormatInfo* formatInfo = image->formatInfo();
+
+    VkExtent3D imageExtent = image->mipLevelExtent(subresources.mipLevel);
+
+    VkExtent3D elementCount = util::computeBlockCount(
+      imageExtent, formatInfo->blockSize);
+    elementCount.depth *= subresources.layerCount;
+
+    auto slice = m_transferCmd->stagedAlloc(
+      formatInfo->elementSize * util::flattenImageExtent(elementCount));
+
+    m_device->imagePacker()->packImageData(
+      reinterpret_cast<char*>(slice.mapPtr),
+      reinterpret_cast<const char*>(data),
+      elementCount, formatInfo->elementSize,
+      pitchPerRow, pitchPerLayer);
+
+    VkImageLayout transferLayout = image->pickLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+
+    // The previous contents are discarded, so we can
+    // transition the image from the undefined layout
+    // without acquiring ownership of the image first.
+    VkImageMemoryBarrier barrier;
+    barrier.sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.pNext               = nullptr;
+    barrier.srcAccessMask       = 0;
+    barrier.dstAccessMask       = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.oldLayout           = VK_IMAGE_LAYOUT_UNDEFINED;
+    barrier.newLayout           = transferLayout;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image               = image->handle();
+    barrier.subresourceRange    = vk::makeSubresourceRange(subresources);
+    barrier.subresourceRange.aspectMask = formatInfo->aspectMask;
+
+    m_transferCmd->cmdPipelineBarrier(
+      VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+      VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+      0, nullptr, 0, nullptr, 1, &barrier);
+
+    VkBufferImageCopy region;
+    region.bufferOffset       = slice.offset;
+    region.bufferRowLength    = 0;
+    region.bufferImageHeight  = 0;
+    region.imageSubresource   = subresources;
+    region.imageOffset        = VkOffset3D { 0, 0, 0 };
+    region.imageExtent        = imageExtent;
+
+    m_transferCmd->stagedBufferImageCopy(image->handle(),
+      transferLayout, region, slice);
+
+    // Release the image to the graphics queue family
+    // and transition it to its default layout
+    barrier.srcAccessMask       = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask       = 0;
+    barrier.oldLayout           = transferLayout;
+    barrier.newLayout           = image->info().layout;
+    barrier.srcQueueFamilyIndex = m_device->transferQueue().queueFamily;
+    barrier.dstQueueFamilyIndex = m_device->graphicsQueue().queueFamily;
+    m_imgReleases.push_back(barrier);
+
+    barrier.srcAccessMask       = 0;
+    barrier.dstAccessMask       = image->info().access;
+    m_imgAcquires.push_back(barrier);
+
+    m_acquireStages |= image->info().stages;
+
+    m_transferCmd->trackResource(image);
+    m_resources.push_back(image);
+  }
+
+
+  void DxvkTransferContext::flush() {
+    if (m_transferCmd == nullptr)
+      return;
+
+    m_transferCmd->cmdPipelineBarrier(
+      VK_PIPELINE_STAGE_TRANSFER_BIT,
+      VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr,
+      m_bufReleases.size(), m_bufReleases.data(),
+      m_imgReleases.size(), m_imgReleases.data());
+
+    m_transferCmd->endRecording();
+
+    // The acquire operations have to be executed on the
+    // graphics queue, and must wait for the transfer
+    // submission to complete.
+    Rc<DxvkCommandList> graphicsCmd = m_device->createCommandList();
+    graphicsCmd->beginRecording();
+    graphicsCmd->cmdPipelineBarrier(
+      VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+      m_acquireStages ? m_acquireStages : VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+      0, 0, nullptr,
+      m_bufAcquires.size(), m_bufAcquires.data(),
+      m_imgAcquires.size(), m_imgAcquires.data());
+    graphicsCmd->endRecording();
+
+    for (const auto& resource : m_resources)
+      graphicsCmd->trackResource(resource);
+
+    Rc<DxvkSemaphore> semaphore = m_device->createSemaphore();
+
+    m_device->submitCommandList(
+      std::exchange(m_transferCmd, nullptr),
+      nullptr, semaphore);
+
+    m_device->submitCommandList(
+      graphicsCmd, semaphore, nullptr);
+
+    m_bufReleases.clear();
+    m_bufAcquires.clear();
+    m_imgReleases.clear();
+    m_imgAcquires.clear();
+    m_resources.clear();
+
+    m_acquireStages = 0;
+  }
+
+
+  void DxvkTransferContext::beginRecording() {
+    if (m_transferCmd == nullptr) {
+      m_transferCmd = m_device->createTransferCommandList();
+      m_transferCmd->beginRecording();
+    }
+  }
+
+}
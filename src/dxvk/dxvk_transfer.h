@@ -0,0 +1,104 @@
+#pragma once
+
+#include "dxvk_cmdlist.h"
+#include "dxvk_image.h"
+#include "dxvk_sync.h"
+
+namespace dxvk {
+  
+  class DxvkDevice;
+  
+  /**
+   * \brief Transfer context
+   * 
+   * Records buffer and image uploads into command lists
+   * for the dedicated transfer queue, so that resource
+   * initialization does not stall rendering. Uploaded
+   * resources are released to the graphics queue family,
+   * and the matching acquire barriers are recorded into
+   * a graphics command list which waits for the transfer
+   * submission to complete.
+   * 
+   * Resources must not have been used by the graphics
+   * queue before, and uploads must cover entire image
+   * subresources, since the transfer queue may have a
+   * coarse image transfer granularity.
+   */
+  class DxvkTransferContext : public RcObject {
+    
+  public:
+    
+    DxvkTransferContext(DxvkDevice* device);
+    ~DxvkTransferContext();
+    
+    /**
+     * \brief Checks whether the context has pending uploads
+     * \returns \c true if there are unsubmitted uploads
+     */
+    bool hasPendingUploads() const {
+      return m_transferCmd != nullptr;
+    }
+    
+    /**
+     * \brief Uploads buffer data
+     * 
+     * \param [in] buffer The buffer to write to
+     * \param [in] offset Offset of the region to update
+     * \param [in] size Number of bytes to write
+     * \param [in] data Data to write
+     */
+    void uploadBuffer(
+      const Rc<DxvkBuffer>&           buffer,
+            VkDeviceSize              offset,
+            VkDeviceSize              size,
+      const void*                     data);
+    
+    /**
+     * \brief Uploads image data
+     * 
+     * Writes an entire mip level of the given
+     * array layers. The previous contents of
+     * the image subresources are discarded.
+     * \param [in] image The image to write to
+     * \param [in] subresources Subresources to update
+     * \param [in] data Source data
+     * \param [in] pitchPerRow Row pitch of the source data
+     * \param [in] pitchPerLayer Layer pitch of the source data
+     */
+    void uploadImage(
+      const Rc<DxvkImage>&            image,
+      const VkImageSubresourceLayers& subresources,
+      const void*                     data,
+            VkDeviceSize              pitchPerRow,
+            VkDeviceSize              pitchPerLayer);
+    
+    /**
+     * \brief Submits pending uploads
+     * 
+     * Submits the transfer command list, followed by
+     * a graphics command list that acquires ownership
+     * of all uploaded resources. Subsequent graphics
+     * submissions are ordered after the uploads.
+     */
+    void flush();
+    
+  private:
+    
+    DxvkDevice*                         m_device;
+    
+    Rc<DxvkCommandList>                 m_transferCmd;
+    
+    std::vector<VkBufferMemoryBarrier>  m_bufReleases;
+    std::vector<VkBufferMemoryBarrier>  m_bufAcquires;
+    std::vector<VkImageMemoryBarrier>   m_imgReleases;
+    std::vector<VkImageMemoryBarrier>   m_imgAcquires;
+    
+    std::vector<Rc<DxvkResource>>       m_resources;
+    
+    VkPipelineStageFlags                m_acquireStages = 0;
+    
+    void beginRecording();
+    
+  };
+  
+}
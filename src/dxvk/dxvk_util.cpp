@@ -1,5 +1,10 @@
 #include <cstring>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define DXVK_UTIL_SSE2
+#endif
+
 #include "dxvk_format.h"
 #include "dxvk_util.h"
 
@@ -38,6 +43,50 @@ namespace dxvk::util {
   }
   
   
+  void streamData(
+          void*             dst,
+    const void*             src,
+          size_t            size) {
+#ifdef DXVK_UTIL_SSE2
+    auto dstBytes = reinterpret_cast<char*>(dst);
+    auto srcBytes = reinterpret_cast<const char*>(src);
+    
+    // Non-temporal stores require an aligned destination,
+    // so copy the first few bytes the regular way
+    size_t head = std::min(size, size_t(-reinterpret_cast<uintptr_t>(dstBytes) & 0xF));
+    std::memcpy(dstBytes, srcBytes, head);
+    
+    dstBytes += head;
+    srcBytes += head;
+    size     -= head;
+    
+    while (size >= 64) {
+      __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(srcBytes +  0));
+      __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(srcBytes + 16));
+      __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(srcBytes + 32));
+      __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(srcBytes + 48));
+      
+      _mm_stream_si128(reinterpret_cast<__m128i*>(dstBytes +  0), a);
+      _mm_stream_si128(reinterpret_cast<__m128i*>(dstBytes + 16), b);
+      _mm_stream_si128(reinterpret_cast<__m128i*>(dstBytes + 32), c);
+      _mm_stream_si128(reinterpret_cast<__m128i*>(dstBytes + 48), d);
+      
+      dstBytes += 64;
+      srcBytes += 64;
+      size     -= 64;
+    }
+    
+    std::memcpy(dstBytes, srcBytes, size);
+    
+    // Make the stores visible to other threads and
+    // the GPU before the data is used any further
+    _mm_sfence();
+#else
+    std::memcpy(dst, src, size);
+#endif
+  }
+  
+  
   void packImageData(
           char*             dstData,
     const char*             srcData,
@@ -52,12 +101,20 @@ namespace dxvk::util {
     const bool directCopy = ((bytesPerRow   == pitchPerRow  ) || (blockCount.height == 1))
                          && ((bytesPerLayer == pitchPerLayer) || (blockCount.depth  == 1));
     
+    // Large uploads will not fit into the cache anyway,
+    // so bypass it in order to not evict useful data
+    constexpr VkDeviceSize StreamThreshold = 256 * 1024;
+    
+    auto copyFn = bytesTotal >= StreamThreshold
+      ? &streamData
+      : [] (void* dst, const void* src, size_t size) { std::memcpy(dst, src, size); };
+    
     if (directCopy) {
-      std::memcpy(dstData, srcData, bytesTotal);
+      copyFn(dstData, srcData, bytesTotal);
     } else {
       for (uint32_t i = 0; i < blockCount.depth; i++) {
         for (uint32_t j = 0; j < blockCount.height; j++) {
-          std::memcpy(
+          copyFn(
             dstData + j * bytesPerRow,
             srcData + j * pitchPerRow,
             bytesPerRow);
@@ -21,6 +21,21 @@ namespace dxvk::util {
    */
   uint32_t computeMipLevelCount(VkExtent3D imageSize);
   
+  /**
+   * \brief Copies data using non-temporal stores
+   * 
+   * Meant for large copies into write-combined memory
+   * which will not be read again by the host. Falls
+   * back to \c memcpy if SSE2 is not available.
+   * \param [in] dst Destination pointer
+   * \param [in] src Source pointer
+   * \param [in] size Number of bytes to copy
+   */
+  void streamData(
+          void*             dst,
+    const void*             src,
+          size_t            size);
+  
   /**
    * \brief Writes tightly packed image data to a buffer
    * 
@@ -52,10 +52,12 @@ namespace dxvk::hud {
     const uint64_t gpCalls = m_diffCounters.getCtr(DxvkStatCounter::CmdDrawCalls)       / frameCount;
     const uint64_t cpCalls = m_diffCounters.getCtr(DxvkStatCounter::CmdDispatchCalls)   / frameCount;
     const uint64_t rpCalls = m_diffCounters.getCtr(DxvkStatCounter::CmdRenderPassCount) / frameCount;
+    const uint64_t barriers = m_diffCounters.getCtr(DxvkStatCounter::CmdBarrierCount)   / frameCount;
     
     const std::string strDrawCalls      = str::format("Draw calls:     ", gpCalls);
     const std::string strDispatchCalls  = str::format("Dispatch calls: ", cpCalls);
     const std::string strRenderPasses   = str::format("Render passes:  ", rpCalls);
+    const std::string strBarriers       = str::format("Barriers:       ", barriers);
     
     renderer.drawText(context, 16.0f,
       { position.x, position.y },
@@ -72,7 +74,12 @@ namespace dxvk::hud {
       { 1.0f, 1.0f, 1.0f, 1.0f },
       strRenderPasses);
     
-    return { position.x, position.y + 64 };
+    renderer.drawText(context, 16.0f,
+      { position.x, position.y + 60.0f },
+      { 1.0f, 1.0f, 1.0f, 1.0f },
+      strBarriers);
+    
+    return { position.x, position.y + 84 };
   }
   
   
@@ -82,15 +89,33 @@ namespace dxvk::hud {
           HudPos            position) {
     const uint64_t frameCount = std::max<uint64_t>(m_diffCounters.getCtr(DxvkStatCounter::QueuePresentCount), 1);
     const uint64_t numSubmits = m_diffCounters.getCtr(DxvkStatCounter::QueueSubmitCount) / frameCount;
+    const uint64_t numWaits   = m_diffCounters.getCtr(DxvkStatCounter::SyncWaitCount)    / frameCount;
+    const uint64_t waitTimeUs = m_diffCounters.getCtr(DxvkStatCounter::SyncWaitTime)     / frameCount;
+    const uint64_t numStalls  = m_diffCounters.getCtr(DxvkStatCounter::ReadbackStallCount) / frameCount;
+    const uint64_t stallTime  = m_diffCounters.getCtr(DxvkStatCounter::ReadbackStallTime)  / frameCount;
     
+    // Time spent blocking is CPU time that
+    // would otherwise be spent spinning
     const std::string strSubmissions = str::format("Queue submissions: ", numSubmits);
+    const std::string strSyncWaits   = str::format("Blocking waits:    ", numWaits, " (", waitTimeUs, " us)");
+    const std::string strStalls      = str::format("Readback stalls:   ", numStalls, " (", stallTime, " us)");
     
     renderer.drawText(context, 16.0f,
       { position.x, position.y },
       { 1.0f, 1.0f, 1.0f, 1.0f },
       strSubmissions);
     
-    return { position.x, position.y + 24.0f };
+    renderer.drawText(context, 16.0f,
+      { position.x, position.y + 20.0f },
+      { 1.0f, 1.0f, 1.0f, 1.0f },
+      strSyncWaits);
+    
+    renderer.drawText(context, 16.0f,
+      { position.x, position.y + 40.0f },
+      { 1.0f, 1.0f, 1.0f, 1.0f },
+      strStalls);
+    
+    return { position.x, position.y + 64.0f };
   }
   
   
@@ -45,6 +45,14 @@ namespace dxvk {
       return m_code.size() * sizeof(uint32_t);
     }
     
+    /**
+     * \brief Code size, in dwords
+     * \returns Code size, in dwords
+     */
+    size_t dwords() const {
+      return m_code.size();
+    }
+    
     /**
      * \brief Begin instruction iterator
      * 
@@ -0,0 +1,117 @@
+#include "spirv_compression.h"
+
+namespace dxvk {
+
+  SpirvCompressedBuffer::SpirvCompressedBuffer() {
+
+  }
+
+
+  SpirvCompressedBuffer::SpirvCompressedBuffer(
+    const SpirvCodeBuffer&  code)
+  : m_dwords(code.dwords()) {
+    const uint32_t* words = code.data();
+
+    // Check whether we can safely walk the instruction
+    // stream, otherwise encode all words as they are
+    m_headerWords = m_dwords >= 5 && words[0] == spv::MagicNumber ? 5 : 0;
+
+    size_t offset = m_headerWords;
+
+    while (offset < m_dwords) {
+      uint32_t length = words[offset] >> spv::WordCountShift;
+
+      if (!length || length > m_dwords - offset)
+        break;
+
+      offset += length;
+    }
+
+    m_structured = offset == m_dwords;
+    m_code.reserve(m_dwords * 2);
+
+    offset = 0;
+
+    if (m_structured) {
+      for (; offset < m_headerWords; offset++)
+        putWord(words[offset]);
+    }
+
+    while (offset < m_dwords) {
+      if (m_structured) {
+        uint32_t length = words[offset] >> spv::WordCountShift;
+
+        putWord(length);
+        putWord(words[offset] & spv::OpCodeMask);
+
+        for (uint32_t i = 1; i < length; i++)
+          putWord(words[offset + i]);
+
+        offset += length;
+      } else {
+        putWord(words[offset++]);
+      }
+    }
+
+    m_code.shrink_to_fit();
+  }
+
+
+  SpirvCompressedBuffer::~SpirvCompressedBuffer() {
+
+  }
+
+
+  SpirvCodeBuffer SpirvCompressedBuffer::decompress() const {
+    std::vector<uint32_t> words(m_dwords);
+
+    const uint8_t* src = m_code.data();
+
+    auto getWord = [&src] () {
+      uint32_t word  = 0;
+      uint32_t shift = 0;
+
+      while (*src & 0x80) {
+        word  |= uint32_t(*(src++) & 0x7F) << shift;
+        shift += 7;
+      }
+
+      return word | (uint32_t(*(src++)) << shift);
+    };
+
+    size_t offset = 0;
+
+    if (m_structured) {
+      for (; offset < m_headerWords; offset++)
+        words[offset] = getWord();
+    }
+
+    while (offset < m_dwords) {
+      if (m_structured) {
+        uint32_t length = getWord();
+
+        words[offset] = getWord() | (length << spv::WordCountShift);
+
+        for (uint32_t i = 1; i < length; i++)
+          words[offset + i] = getWord();
+
+        offset += length;
+      } else {
+        words[offset++] = getWord();
+      }
+    }
+
+    return SpirvCodeBuffer(words.size(), words.data());
+  }
+
+
+  void SpirvCompressedBuffer::putWord(uint32_t word) {
+    while (word >= 0x80) {
+      m_code.push_back(uint8_t(word) | 0x80);
+      word >>= 7;
+    }
+
+    m_code.push_back(uint8_t(word));
+  }
+
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "spirv_code_buffer.h"
+
+namespace dxvk {
+
+  /**
+   * \brief Compressed SPIR-V code buffer
+   *
+   * Stores SPIR-V code using a variable-length encoding
+   * for each word, which works well since most words are
+   * small IDs, literals or enum values. Instruction words
+   * are split into the word count and opcode so that they
+   * also fit into one or two bytes each. Code that cannot
+   * be parsed as SPIR-V instructions is still encoded
+   * correctly, just less efficiently.
+   */
+  class SpirvCompressedBuffer {
+
+  public:
+
+    SpirvCompressedBuffer();
+
+    explicit SpirvCompressedBuffer(
+      const SpirvCodeBuffer&  code);
+
+    ~SpirvCompressedBuffer();
+
+    /**
+     * \brief Compressed size, in bytes
+     * \returns Compressed size, in bytes
+     */
+    size_t size() const {
+      return m_code.size();
+    }
+
+    /**
+     * \brief Uncompressed size, in dwords
+     * \returns Uncompressed size, in dwords
+     */
+    size_t dwords() const {
+      return m_dwords;
+    }
+
+    /**
+     * \brief Decompresses the code
+     * \returns The original code buffer
+     */
+    SpirvCodeBuffer decompress() const;
+
+  private:
+
+    std::vector<uint8_t> m_code;
+    size_t               m_dwords      = 0;
+    size_t               m_headerWords = 0;
+    bool                 m_structured  = false;
+
+    void putWord(uint32_t word);
+
+  };
+
+}
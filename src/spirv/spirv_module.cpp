@@ -4,6 +4,33 @@
 
 namespace dxvk {
   
+  static uint32_t hashTypeConst(
+          spv::Op                 op,
+          uint32_t                typeId,
+          uint32_t                argCount,
+    const uint32_t*               argIds) {
+    uint32_t hash = 2166136261u;
+    
+    auto addWord = [&hash] (uint32_t word) {
+      hash = (hash ^ word) * 16777619u;
+    };
+    
+    addWord(uint32_t(op));
+    addWord(typeId);
+    addWord(argCount);
+    
+    for (uint32_t i = 0; i < argCount; i++)
+      addWord(argIds[i]);
+    
+    // Mix the bits so that the lower bits, which
+    // are used to index the table, are usable
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6bu;
+    hash ^= hash >> 13;
+    return hash;
+  }
+  
+  
   SpirvModule:: SpirvModule() {
     this->instImportGlsl450();
   }
@@ -333,9 +360,13 @@ namespace dxvk {
       ? spv::OpSpecConstantTrue
       : spv::OpSpecConstantFalse;
     
+    size_t offset = m_typeConstDefs.dwords();
+    
     m_typeConstDefs.putIns  (op, 3);
     m_typeConstDefs.putWord (typeId);
     m_typeConstDefs.putWord (resultId);
+    
+    this->indexTypeConst(offset);
     return resultId;
   }
     
@@ -345,10 +376,14 @@ namespace dxvk {
           uint32_t                value) {
     uint32_t resultId = this->allocateId();
     
+    size_t offset = m_typeConstDefs.dwords();
+    
     m_typeConstDefs.putIns  (spv::OpSpecConstant, 4);
     m_typeConstDefs.putWord (typeId);
     m_typeConstDefs.putWord (resultId);
     m_typeConstDefs.putWord (value);
+    
+    this->indexTypeConst(offset);
     return resultId;
   }
   
@@ -565,10 +600,14 @@ namespace dxvk {
           uint32_t                length) {
     uint32_t resultId = this->allocateId();
     
+    size_t offset = m_typeConstDefs.dwords();
+    
     m_typeConstDefs.putIns (spv::OpTypeArray, 4);
     m_typeConstDefs.putWord(resultId);
     m_typeConstDefs.putWord(typeId);
     m_typeConstDefs.putWord(length);
+    
+    this->indexTypeConst(offset);
     return resultId;
   }
   
@@ -586,9 +625,13 @@ namespace dxvk {
           uint32_t                typeId) {
     uint32_t resultId = this->allocateId();
     
+    size_t offset = m_typeConstDefs.dwords();
+    
     m_typeConstDefs.putIns (spv::OpTypeRuntimeArray, 3);
     m_typeConstDefs.putWord(resultId);
     m_typeConstDefs.putWord(typeId);
+    
+    this->indexTypeConst(offset);
     return resultId;
   }
   
@@ -621,11 +664,15 @@ namespace dxvk {
     const uint32_t*               memberTypes) {
     uint32_t resultId = this->allocateId();
     
+    size_t offset = m_typeConstDefs.dwords();
+    
     m_typeConstDefs.putIns (spv::OpTypeStruct, 2 + memberCount);
     m_typeConstDefs.putWord(resultId);
     
     for (uint32_t i = 0; i < memberCount; i++)
       m_typeConstDefs.putWord(memberTypes[i]);
+    
+    this->indexTypeConst(offset);
     return resultId;
   }
   
@@ -3056,26 +3103,25 @@ namespace dxvk {
           uint32_t                argCount,
     const uint32_t*               argIds) {
     // Since the type info is stored in the code buffer,
-    // we can use the code buffer to look up type IDs as
-    // well. Result IDs are always stored as argument 1.
-    for (auto ins : m_typeConstDefs) {
-      bool match = ins.opCode() == op
-                && ins.length() == 2 + argCount;
-      
-      for (uint32_t i = 0; i < argCount && match; i++)
-        match &= ins.arg(2 + i) == argIds[i];
-      
-      if (match)
-        return ins.arg(1);
-    }
+    // the lookup table only needs to store offsets into
+    // the code buffer. Result IDs are stored as argument 1.
+    uint32_t hash = hashTypeConst(op, 0, argCount, argIds);
+    uint32_t typeId = this->findTypeConst(op, 0, argCount, argIds, hash);
+    
+    if (typeId != 0)
+      return typeId;
     
     // Type not yet declared, create a new one.
     uint32_t resultId = this->allocateId();
+    size_t   offset   = m_typeConstDefs.dwords();
+    
     m_typeConstDefs.putIns (op, 2 + argCount);
     m_typeConstDefs.putWord(resultId);
     
     for (uint32_t i = 0; i < argCount; i++)
       m_typeConstDefs.putWord(argIds[i]);
+    
+    this->indexTypeConst(offset);
     return resultId;
   }
   
@@ -3086,30 +3132,119 @@ namespace dxvk {
           uint32_t                argCount,
     const uint32_t*               argIds) {
     // Avoid declaring constants multiple times
-    for (auto ins : m_typeConstDefs) {
-      bool match = ins.opCode() == op
-                && ins.length() == 3 + argCount
-                && ins.arg(1)   == typeId;
-      
-      for (uint32_t i = 0; i < argCount && match; i++)
-        match &= ins.arg(3 + i) == argIds[i];
-      
-      if (match)
-        return ins.arg(2);
-    }
+    uint32_t hash = hashTypeConst(op, typeId, argCount, argIds);
+    uint32_t constId = this->findTypeConst(op, typeId, argCount, argIds, hash);
+    
+    if (constId != 0)
+      return constId;
     
     // Constant not yet declared, make a new one
     uint32_t resultId = this->allocateId();
+    size_t   offset   = m_typeConstDefs.dwords();
+    
     m_typeConstDefs.putIns (op, 3 + argCount);
     m_typeConstDefs.putWord(typeId);
     m_typeConstDefs.putWord(resultId);
     
     for (uint32_t i = 0; i < argCount; i++)
       m_typeConstDefs.putWord(argIds[i]);
+    
+    this->indexTypeConst(offset);
     return resultId;
   }
   
   
+  uint32_t SpirvModule::findTypeConst(
+          spv::Op                 op,
+          uint32_t                typeId,
+          uint32_t                argCount,
+    const uint32_t*               argIds,
+          uint32_t                hash) const {
+    if (m_typeConstTable.empty())
+      return 0;
+    
+    // Types store their result ID in the first operand,
+    // constants store the type ID there instead.
+    const uint32_t argOffset = typeId ? 3 : 2;
+    const uint32_t mask      = m_typeConstTable.size() - 1;
+    
+    for (uint32_t i = hash & mask; ; i = (i + 1) & mask) {
+      const TypeConstEntry& entry = m_typeConstTable[i];
+      
+      if (entry.offset == ~0u)
+        return 0;
+      
+      if (entry.hash != hash)
+        continue;
+      
+      const uint32_t* ins = m_typeConstDefs.data() + entry.offset;
+      
+      bool match = spv::Op(ins[0] & spv::OpCodeMask) == op
+                && (ins[0] >> spv::WordCountShift) == argOffset + argCount
+                && (!typeId || ins[1] == typeId);
+      
+      for (uint32_t j = 0; j < argCount && match; j++)
+        match &= ins[argOffset + j] == argIds[j];
+      
+      if (match)
+        return ins[argOffset - 1];
+    }
+  }
+  
+  
+  void SpirvModule::indexTypeConst(
+          size_t                  offset) {
+    const uint32_t* ins = m_typeConstDefs.data() + offset;
+    
+    spv::Op  op        = spv::Op(ins[0] & spv::OpCodeMask);
+    uint32_t length    = ins[0] >> spv::WordCountShift;
+    bool     isType    = op >= spv::OpTypeVoid && op <= spv::OpTypeForwardPointer;
+    uint32_t typeId    = isType ? 0 : ins[1];
+    uint32_t argOffset = isType ? 2 : 3;
+    
+    uint32_t hash = hashTypeConst(op, typeId,
+      length - argOffset, ins + argOffset);
+    
+    // Earlier declarations take precedence, which
+    // matches the order of a linear search.
+    if (this->findTypeConst(op, typeId, length - argOffset, ins + argOffset, hash) != 0)
+      return;
+    
+    // Keep the load factor below 50% so that probe
+    // sequences stay short, and rebuild the table
+    // with the stored hashes when it needs to grow.
+    if (2 * (m_typeConstCount + 1) > m_typeConstTable.size()) {
+      std::vector<TypeConstEntry> oldTable(
+        std::max<size_t>(m_typeConstTable.size() * 2, 256));
+      std::swap(oldTable, m_typeConstTable);
+      
+      const uint32_t mask = m_typeConstTable.size() - 1;
+      
+      for (const auto& entry : oldTable) {
+        if (entry.offset == ~0u)
+          continue;
+        
+        uint32_t i = entry.hash & mask;
+        
+        while (m_typeConstTable[i].offset != ~0u)
+          i = (i + 1) & mask;
+        
+        m_typeConstTable[i] = entry;
+      }
+    }
+    
+    const uint32_t mask = m_typeConstTable.size() - 1;
+    uint32_t i = hash & mask;
+    
+    while (m_typeConstTable[i].offset != ~0u)
+      i = (i + 1) & mask;
+    
+    m_typeConstTable[i].hash   = hash;
+    m_typeConstTable[i].offset = uint32_t(offset);
+    m_typeConstCount += 1;
+  }
+  
+  
   void SpirvModule::instImportGlsl450() {
     m_instExtGlsl450 = this->allocateId();
     const char* name = "GLSL.std.450";
@@ -1059,6 +1059,18 @@ namespace dxvk {
     
   private:
     
+    /**
+     * \brief Type or constant lookup table entry
+     * 
+     * Stores the hash of a declaration's operands as well
+     * as the word offset of the declaration within the
+     * type and constant code buffer.
+     */
+    struct TypeConstEntry {
+      uint32_t hash   = 0;
+      uint32_t offset = ~0u;
+    };
+    
     uint32_t m_id             = 1;
     uint32_t m_instExtGlsl450 = 0;
     
@@ -1074,6 +1086,9 @@ namespace dxvk {
     SpirvCodeBuffer m_variables;
     SpirvCodeBuffer m_code;
     
+    std::vector<TypeConstEntry> m_typeConstTable;
+    uint32_t                    m_typeConstCount = 0;
+    
     uint32_t defType(
             spv::Op                 op, 
             uint32_t                argCount,
@@ -1085,6 +1100,16 @@ namespace dxvk {
             uint32_t                argCount,
       const uint32_t*               argIds);
     
+    uint32_t findTypeConst(
+            spv::Op                 op,
+            uint32_t                typeId,
+            uint32_t                argCount,
+      const uint32_t*               argIds,
+            uint32_t                hash) const;
+    
+    void indexTypeConst(
+            size_t                  offset);
+    
     void instImportGlsl450();
     
     uint32_t getImageOperandWordCount(
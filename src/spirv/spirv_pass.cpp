@@ -0,0 +1,143 @@
+#include "spirv_pass.h"
+
+namespace dxvk {
+
+  bool SpirvPass::isSupportedInstruction(spv::Op op) {
+    switch (op) {
+      case spv::OpNop:
+      case spv::OpUndef:
+      case spv::OpExtInst:
+      case spv::OpFunction:
+      case spv::OpFunctionParameter:
+      case spv::OpFunctionEnd:
+      case spv::OpFunctionCall:
+      case spv::OpVariable:
+      case spv::OpImageTexelPointer:
+      case spv::OpLoad:
+      case spv::OpStore:
+      case spv::OpAccessChain:
+      case spv::OpInBoundsAccessChain:
+      case spv::OpArrayLength:
+      case spv::OpVectorExtractDynamic:
+      case spv::OpVectorInsertDynamic:
+      case spv::OpVectorShuffle:
+      case spv::OpCompositeConstruct:
+      case spv::OpCompositeExtract:
+      case spv::OpCompositeInsert:
+      case spv::OpCopyObject:
+      case spv::OpTranspose:
+      case spv::OpSampledImage:
+      case spv::OpImageSampleImplicitLod:
+      case spv::OpImageSampleExplicitLod:
+      case spv::OpImageSampleDrefImplicitLod:
+      case spv::OpImageSampleDrefExplicitLod:
+      case spv::OpImageFetch:
+      case spv::OpImageGather:
+      case spv::OpImageDrefGather:
+      case spv::OpImageRead:
+      case spv::OpImageWrite:
+      case spv::OpImage:
+      case spv::OpControlBarrier:
+      case spv::OpMemoryBarrier:
+        return true;
+
+      default:
+        break;
+    }
+
+    // Instruction ranges which only take ID operands
+    return (op >= spv::OpImageQueryFormat             && op <= spv::OpImageQuerySamples)
+        || (op >= spv::OpConvertFToU                  && op <= spv::OpBitcast
+                                                      && op != spv::OpGenericCastToPtrExplicit)
+        || (op >= spv::OpSNegate                      && op <= spv::OpFwidthCoarse)
+        || (op >= spv::OpEmitVertex                   && op <= spv::OpEndStreamPrimitive)
+        || (op >= spv::OpAtomicLoad                   && op <= spv::OpAtomicXor)
+        || (op >= spv::OpPhi                          && op <= spv::OpUnreachable)
+        || (op >= spv::OpGroupNonUniformElect         && op <= spv::OpGroupNonUniformQuadSwap);
+  }
+
+
+  bool SpirvPass::isIdOperand(spv::Op op, uint32_t index) {
+    switch (op) {
+      case spv::OpExtInst:
+      case spv::OpArrayLength:
+        return index != 4;
+
+      case spv::OpFunction:
+      case spv::OpVariable:
+        return index != 3;
+
+      case spv::OpLoad:
+        return index <= 3;
+
+      case spv::OpStore:
+        return index <= 2;
+
+      case spv::OpVectorShuffle:
+      case spv::OpCompositeInsert:
+        return index < 5;
+
+      case spv::OpCompositeExtract:
+        return index < 4;
+
+      case spv::OpImageSampleImplicitLod:
+      case spv::OpImageSampleExplicitLod:
+      case spv::OpImageFetch:
+      case spv::OpImageRead:
+        return index != 5;
+
+      case spv::OpImageSampleDrefImplicitLod:
+      case spv::OpImageSampleDrefExplicitLod:
+      case spv::OpImageGather:
+      case spv::OpImageDrefGather:
+        return index != 6;
+
+      case spv::OpImageWrite:
+        return index != 4;
+
+      case spv::OpLoopMerge:
+        return index < 3;
+
+      case spv::OpSelectionMerge:
+        return index < 2;
+
+      case spv::OpBranchConditional:
+        return index < 4;
+
+      case spv::OpSwitch:
+        return index < 3 || !(index & 1);
+
+      default:
+        break;
+    }
+
+    // Group operation literal for subgroup reductions
+    if (op == spv::OpGroupNonUniformBallotBitCount
+     || (op >= spv::OpGroupNonUniformIAdd && op <= spv::OpGroupNonUniformLogicalXor))
+      return index != 4;
+
+    return true;
+  }
+
+
+  SpirvPassManager::SpirvPassManager() { }
+  SpirvPassManager::~SpirvPassManager() { }
+
+
+  void SpirvPassManager::addPass(std::unique_ptr<SpirvPass>&& pass) {
+    m_passes.push_back(std::move(pass));
+  }
+
+
+  void SpirvPassManager::run(SpirvCodeBuffer& code) const {
+    for (const auto& pass : m_passes) {
+      size_t oldSize = code.size();
+
+      if (pass->run(code)) {
+        Logger::debug(str::format("SPIR-V: ", pass->name(), ": ",
+          oldSize, " -> ", code.size(), " bytes"));
+      }
+    }
+  }
+
+}
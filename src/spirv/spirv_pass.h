@@ -0,0 +1,108 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "spirv_code_buffer.h"
+
+namespace dxvk {
+
+  /**
+   * \brief SPIR-V optimization pass
+   *
+   * Operates on a fully assembled SPIR-V module. Passes
+   * must either produce a valid module or leave the code
+   * unmodified, e.g. if they encounter an instruction
+   * whose operand layout they do not understand.
+   */
+  class SpirvPass {
+
+  public:
+
+    virtual ~SpirvPass() { }
+
+    /**
+     * \brief Pass name
+     * \returns Pass name, for logging
+     */
+    virtual const char* name() const = 0;
+
+    /**
+     * \brief Runs the pass
+     *
+     * \param [in,out] code The SPIR-V module
+     * \returns \c true if the module was modified
+     */
+    virtual bool run(SpirvCodeBuffer& code) = 0;
+
+  protected:
+
+    /**
+     * \brief Checks whether an instruction can be processed
+     *
+     * Returns \c true for instructions that may appear in a
+     * function body and whose operand layout is known to
+     * \ref isIdOperand. Passes that rewrite IDs must not
+     * touch modules containing any other instructions.
+     * \param [in] op Op code
+     * \returns \c true if the instruction is supported
+     */
+    static bool isSupportedInstruction(spv::Op op);
+
+    /**
+     * \brief Checks whether an operand is an ID
+     *
+     * Only valid for instructions that are supported
+     * as per \ref isSupportedInstruction.
+     * \param [in] op Op code
+     * \param [in] index Argument index, starting at 1
+     * \returns \c true if the argument is an ID
+     */
+    static bool isIdOperand(spv::Op op, uint32_t index);
+
+  };
+
+
+  /**
+   * \brief SPIR-V pass manager
+   *
+   * Runs a list of passes on a module in the
+   * order in which they have been added.
+   */
+  class SpirvPassManager {
+
+  public:
+
+    SpirvPassManager();
+    ~SpirvPassManager();
+
+    /**
+     * \brief Checks whether any passes are enabled
+     * \returns \c true if no passes have been added
+     */
+    bool empty() const {
+      return m_passes.empty();
+    }
+
+    /**
+     * \brief Adds a pass
+     * \param [in] pass The pass to add
+     */
+    void addPass(std::unique_ptr<SpirvPass>&& pass);
+
+    /**
+     * \brief Runs all passes on a module
+     *
+     * Logs the module size before and after
+     * each pass that modified the module.
+     * \param [in,out] code The SPIR-V module
+     */
+    void run(SpirvCodeBuffer& code) const;
+
+  private:
+
+    std::vector<std::unique_ptr<SpirvPass>> m_passes;
+
+  };
+
+}
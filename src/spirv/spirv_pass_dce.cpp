@@ -0,0 +1,208 @@
+#include <unordered_map>
+#include <unordered_set>
+
+#include "spirv_pass_dce.h"
+
+namespace dxvk {
+
+  bool SpirvDeadCodePass::run(SpirvCodeBuffer& code) {
+    const uint32_t* words = code.data();
+
+    if (code.dwords() < 5 || words[0] != spv::MagicNumber)
+      return false;
+
+    std::unordered_map<uint32_t, uint32_t> useCounts;
+    std::unordered_map<uint32_t, uint32_t> defOffsets;
+    std::unordered_map<uint32_t, uint32_t> globalOffsets;
+    std::unordered_set<uint32_t>           globalRefs;
+
+    // Count how often each ID is used within function bodies.
+    // Global instructions other than debug names, decorations
+    // and entry points conservatively keep every word alive.
+    bool inFunction = false;
+
+    for (auto ins : code) {
+      spv::Op op = ins.opCode();
+
+      if (!inFunction) {
+        switch (op) {
+          case spv::OpVariable:
+            if (ins.arg(3) != spv::StorageClassOutput)
+              globalOffsets.insert({ ins.arg(2), ins.offset() });
+
+            if (ins.length() > 4)
+              globalRefs.insert(ins.arg(4));
+            break;
+
+          case spv::OpSpecConstantTrue:
+          case spv::OpSpecConstantFalse:
+          case spv::OpSpecConstant:
+            globalOffsets.insert({ ins.arg(2), ins.offset() });
+            break;
+
+          case spv::OpName:
+          case spv::OpMemberName:
+          case spv::OpDecorate:
+          case spv::OpMemberDecorate:
+          case spv::OpEntryPoint:
+            break;
+
+          case spv::OpFunction:
+            inFunction = true;
+            break;
+
+          default:
+            for (uint32_t i = 1; i < ins.length(); i++)
+              globalRefs.insert(ins.arg(i));
+        }
+      } else {
+        if (!isSupportedInstruction(op))
+          return false;
+
+        if (op == spv::OpFunctionEnd)
+          inFunction = false;
+
+        for (uint32_t i = 1; i < ins.length(); i++) {
+          if (isIdOperand(op, i))
+            useCounts[ins.arg(i)] += 1;
+        }
+
+        if (isRemovableInstruction(op))
+          defOffsets.insert({ ins.arg(2), ins.offset() });
+      }
+    }
+
+    // Remove instructions whose result is only referenced by
+    // the instruction itself, and propagate to the operands.
+    std::unordered_set<uint32_t> deadOffsets;
+    std::unordered_set<uint32_t> removedIds;
+    std::vector<uint32_t>        worklist;
+
+    for (const auto& def : defOffsets) {
+      if (useCounts[def.first] == 1)
+        worklist.push_back(def.first);
+    }
+
+    while (!worklist.empty()) {
+      uint32_t id = worklist.back();
+      worklist.pop_back();
+
+      if (!removedIds.insert(id).second)
+        continue;
+
+      SpirvInstruction ins(code.data(), defOffsets.at(id), code.dwords());
+      deadOffsets.insert(ins.offset());
+
+      for (uint32_t i = 1; i < ins.length(); i++) {
+        if (i == 2 || !isIdOperand(ins.opCode(), i))
+          continue;
+
+        uint32_t& count = useCounts[ins.arg(i)];
+
+        if (--count == 1 && defOffsets.find(ins.arg(i)) != defOffsets.end())
+          worklist.push_back(ins.arg(i));
+      }
+    }
+
+    // Remove variables and specialization constants
+    // which are no longer used by any function
+    for (const auto& global : globalOffsets) {
+      if (!useCounts[global.first]
+       && globalRefs.find(global.first) == globalRefs.end()) {
+        deadOffsets.insert(global.second);
+        removedIds.insert(global.first);
+      }
+    }
+
+    if (deadOffsets.empty())
+      return false;
+
+    // Assemble the new module
+    std::vector<uint32_t> result(words, words + 5);
+    result.reserve(code.dwords());
+
+    for (auto ins : code) {
+      spv::Op  op     = ins.opCode();
+      uint32_t offset = ins.offset();
+      uint32_t length = ins.length();
+
+      if (deadOffsets.find(offset) != deadOffsets.end())
+        continue;
+
+      if ((op == spv::OpName || op == spv::OpDecorate)
+       && removedIds.find(ins.arg(1)) != removedIds.end())
+        continue;
+
+      if (op == spv::OpEntryPoint) {
+        // Skip the name string, which ends with the
+        // first word that has its highest byte unset
+        uint32_t index = 3;
+
+        while (ins.arg(index) >> 24)
+          index += 1;
+
+        size_t insOffset = result.size();
+        result.insert(result.end(), words + offset, words + offset + index + 1);
+
+        for (index += 1; index < length; index++) {
+          if (removedIds.find(ins.arg(index)) == removedIds.end())
+            result.push_back(ins.arg(index));
+        }
+
+        result[insOffset] = spv::OpEntryPoint
+          | uint32_t(result.size() - insOffset) << spv::WordCountShift;
+        continue;
+      }
+
+      result.insert(result.end(), words + offset, words + offset + length);
+    }
+
+    code = SpirvCodeBuffer(result.size(), result.data());
+    return true;
+  }
+
+
+  bool SpirvDeadCodePass::isRemovableInstruction(spv::Op op) {
+    switch (op) {
+      case spv::OpUndef:
+      case spv::OpExtInst:
+      case spv::OpImageTexelPointer:
+      case spv::OpLoad:
+      case spv::OpAccessChain:
+      case spv::OpInBoundsAccessChain:
+      case spv::OpArrayLength:
+      case spv::OpVectorExtractDynamic:
+      case spv::OpVectorInsertDynamic:
+      case spv::OpVectorShuffle:
+      case spv::OpCompositeConstruct:
+      case spv::OpCompositeExtract:
+      case spv::OpCompositeInsert:
+      case spv::OpCopyObject:
+      case spv::OpTranspose:
+      case spv::OpSampledImage:
+      case spv::OpImageSampleImplicitLod:
+      case spv::OpImageSampleExplicitLod:
+      case spv::OpImageSampleDrefImplicitLod:
+      case spv::OpImageSampleDrefExplicitLod:
+      case spv::OpImageFetch:
+      case spv::OpImageGather:
+      case spv::OpImageDrefGather:
+      case spv::OpImageRead:
+      case spv::OpImage:
+      case spv::OpPhi:
+        return true;
+
+      default:
+        break;
+    }
+
+    // Arithmetic, conversion, image query and subgroup
+    // instructions have no side effects, and neither do
+    // derivatives since they do not affect control flow.
+    return (op >= spv::OpImageQueryFormat     && op <= spv::OpImageQuerySamples)
+        || (op >= spv::OpConvertFToU          && op <= spv::OpBitcast)
+        || (op >= spv::OpSNegate              && op <= spv::OpFwidthCoarse)
+        || (op >= spv::OpGroupNonUniformElect && op <= spv::OpGroupNonUniformQuadSwap);
+  }
+
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "spirv_pass.h"
+
+namespace dxvk {
+
+  /**
+   * \brief Dead code elimination pass
+   *
+   * Removes instructions without side effects whose
+   * results are never used, as well as global variables
+   * and specialization constants that are not referenced
+   * by any function. Names, decorations and entry point
+   * interface entries of removed objects are removed as
+   * well, so that unused resource bindings disappear from
+   * the module entirely. Output variables are kept since
+   * they are part of the inter-stage interface.
+   */
+  class SpirvDeadCodePass : public SpirvPass {
+
+  public:
+
+    const char* name() const {
+      return "Dead code elimination";
+    }
+
+    bool run(SpirvCodeBuffer& code);
+
+  private:
+
+    static bool isRemovableInstruction(spv::Op op);
+
+  };
+
+}
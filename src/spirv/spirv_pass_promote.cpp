@@ -0,0 +1,306 @@
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "spirv_pass_promote.h"
+
+namespace dxvk {
+
+  bool SpirvPromotePrivateVarsPass::run(SpirvCodeBuffer& code) {
+    const uint32_t* words = code.data();
+
+    if (code.dwords() < 5 || words[0] != spv::MagicNumber)
+      return false;
+
+    struct VarInfo {
+      uint32_t ptrTypeId  = 0;
+      uint32_t function   = ~0u;
+      uint32_t loadCount  = 0;
+      bool     excluded   = false;
+      std::vector<uint32_t> stores;
+    };
+
+    std::unordered_map<uint32_t, VarInfo>  vars;
+    std::unordered_map<uint32_t, uint32_t> privatePtrTypes;
+    std::unordered_map<uint32_t, uint32_t> functionPtrTypes;
+    std::unordered_set<uint32_t>           interfaceIds;
+    std::vector<uint32_t>                  functionLabels;
+
+    // Gather all private variables and check how they are used.
+    // We cannot safely rewrite IDs in instructions that we do
+    // not know the layout of, so bail out if we find any.
+    bool inFunction = false;
+
+    for (auto ins : code) {
+      spv::Op op = ins.opCode();
+
+      if (!inFunction) {
+        switch (op) {
+          case spv::OpTypePointer:
+            if (ins.arg(2) == spv::StorageClassPrivate)
+              privatePtrTypes.insert({ ins.arg(1), ins.arg(3) });
+            if (ins.arg(2) == spv::StorageClassFunction)
+              functionPtrTypes.insert({ ins.arg(3), ins.arg(1) });
+            break;
+
+          case spv::OpVariable:
+            if (ins.arg(3) == spv::StorageClassPrivate) {
+              VarInfo info;
+              info.ptrTypeId = ins.arg(1);
+              info.excluded  = ins.length() > 4
+                || interfaceIds.find(ins.arg(2)) != interfaceIds.end();
+              vars.insert({ ins.arg(2), std::move(info) });
+            } break;
+
+          case spv::OpEntryPoint: {
+            // Skip the name string, which ends with the
+            // first word that has its highest byte unset
+            uint32_t index = 3;
+
+            while (ins.arg(index) >> 24)
+              index += 1;
+
+            for (index += 1; index < ins.length(); index++)
+              interfaceIds.insert(ins.arg(index));
+          } break;
+
+          case spv::OpDecorate:
+            interfaceIds.insert(ins.arg(1));
+            break;
+
+          case spv::OpFunction:
+            functionLabels.push_back(0);
+            inFunction = true;
+            break;
+
+          default:
+            break;
+        }
+      } else {
+        if (!isSupportedInstruction(op))
+          return false;
+
+        if (op == spv::OpFunctionEnd)
+          inFunction = false;
+
+        if (op == spv::OpLabel && !functionLabels.back())
+          functionLabels.back() = ins.offset() + ins.length();
+
+        uint32_t function = functionLabels.size() - 1;
+
+        for (uint32_t i = 1; i < ins.length(); i++) {
+          if (!isIdOperand(op, i))
+            continue;
+
+          auto var = vars.find(ins.arg(i));
+
+          if (var == vars.end())
+            continue;
+
+          bool isAccess = (op == spv::OpLoad  && i == 3)
+                       || (op == spv::OpStore && i == 1);
+
+          if (!isAccess)
+            var->second.excluded = true;
+
+          if (var->second.function == ~0u)
+            var->second.function = function;
+          else if (var->second.function != function)
+            var->second.excluded = true;
+        }
+      }
+    }
+
+    auto getVar = [&vars] (uint32_t id) -> VarInfo* {
+      auto var = vars.find(id);
+
+      return var != vars.end() && !var->second.excluded
+        ? &var->second : nullptr;
+    };
+
+    // Forward values within each basic block. Stores that are
+    // overwritten before the end of the block are dead, since
+    // any load in between would have been forwarded as well.
+    struct VarState {
+      uint32_t valueId;
+      uint32_t storeOffset;
+    };
+
+    std::unordered_map<uint32_t, VarState> varStates;
+    std::unordered_map<uint32_t, uint32_t> valueIds;
+    std::unordered_set<uint32_t>           deadOffsets;
+
+    auto getValueId = [&valueIds] (uint32_t id) {
+      auto entry = valueIds.find(id);
+      return entry != valueIds.end() ? entry->second : id;
+    };
+
+    inFunction = false;
+
+    for (auto ins : code) {
+      spv::Op op = ins.opCode();
+
+      if (op == spv::OpFunction)
+        inFunction = true;
+
+      if (!inFunction)
+        continue;
+
+      switch (op) {
+        case spv::OpLabel:
+          varStates.clear();
+          break;
+
+        case spv::OpLoad: {
+          VarInfo* var = getVar(ins.arg(3));
+
+          if (var != nullptr) {
+            auto state = varStates.find(ins.arg(3));
+
+            if (state != varStates.end()) {
+              valueIds.insert({ ins.arg(2), state->second.valueId });
+              deadOffsets.insert(ins.offset());
+            } else {
+              varStates.insert({ ins.arg(3), { ins.arg(2), ~0u } });
+              var->loadCount += 1;
+            }
+          }
+        } break;
+
+        case spv::OpStore: {
+          VarInfo* var = getVar(ins.arg(1));
+
+          if (var != nullptr) {
+            auto state = varStates.find(ins.arg(1));
+
+            if (state != varStates.end() && state->second.storeOffset != ~0u)
+              deadOffsets.insert(state->second.storeOffset);
+
+            varStates[ins.arg(1)] = { getValueId(ins.arg(2)), ins.offset() };
+            var->stores.push_back(ins.offset());
+          }
+        } break;
+
+        case spv::OpFunctionEnd:
+          inFunction = false;
+          break;
+
+        default:
+          break;
+      }
+    }
+
+    // Remove variables that are never read, and move the
+    // remaining ones into their respective functions.
+    std::unordered_set<uint32_t>           removedIds;
+    std::unordered_map<uint32_t, uint32_t> newPtrTypes;
+    std::vector<std::vector<std::pair<uint32_t, uint32_t>>> functionVars(functionLabels.size());
+
+    uint32_t boundIds = words[3];
+
+    for (auto& var : vars) {
+      if (var.second.excluded)
+        continue;
+
+      if (!var.second.loadCount) {
+        for (uint32_t offset : var.second.stores)
+          deadOffsets.insert(offset);
+
+        removedIds.insert(var.first);
+      } else {
+        uint32_t pointeeTypeId = privatePtrTypes.at(var.second.ptrTypeId);
+        auto ptrType = functionPtrTypes.find(pointeeTypeId);
+
+        if (ptrType == functionPtrTypes.end()) {
+          ptrType = functionPtrTypes.insert({ pointeeTypeId, boundIds++ }).first;
+          newPtrTypes.insert({ var.second.ptrTypeId, ptrType->second });
+        }
+
+        functionVars[var.second.function].push_back({ ptrType->second, var.first });
+      }
+    }
+
+    for (auto& list : functionVars)
+      std::sort(list.begin(), list.end());
+
+    if (removedIds.empty() && deadOffsets.empty()
+     && std::all_of(functionVars.begin(), functionVars.end(),
+          [] (const auto& v) { return v.empty(); }))
+      return false;
+
+    for (const auto& pair : valueIds)
+      removedIds.insert(pair.first);
+
+    // Assemble the new module
+    std::vector<uint32_t> result(words, words + 5);
+    result.reserve(code.dwords());
+    result[3] = boundIds;
+
+    uint32_t function = 0;
+    inFunction = false;
+
+    for (auto ins : code) {
+      spv::Op  op     = ins.opCode();
+      uint32_t offset = ins.offset();
+      uint32_t length = ins.length();
+
+      if (deadOffsets.find(offset) != deadOffsets.end())
+        continue;
+
+      if (op == spv::OpFunction)
+        inFunction = true;
+
+      if (!inFunction) {
+        if (op == spv::OpVariable && ins.arg(3) == spv::StorageClassPrivate) {
+          VarInfo* var = getVar(ins.arg(2));
+
+          if (var != nullptr)
+            continue;
+        }
+
+        if ((op == spv::OpName || op == spv::OpDecorate)
+         && removedIds.find(ins.arg(1)) != removedIds.end())
+          continue;
+
+        result.insert(result.end(), words + offset, words + offset + length);
+
+        if (op == spv::OpTypePointer) {
+          auto ptrType = newPtrTypes.find(ins.arg(1));
+
+          if (ptrType != newPtrTypes.end()) {
+            result.push_back(spv::OpTypePointer | (4u << spv::WordCountShift));
+            result.push_back(ptrType->second);
+            result.push_back(spv::StorageClassFunction);
+            result.push_back(ins.arg(3));
+          }
+        }
+      } else {
+        result.push_back(words[offset]);
+
+        for (uint32_t i = 1; i < length; i++) {
+          result.push_back(isIdOperand(op, i)
+            ? getValueId(words[offset + i])
+            : words[offset + i]);
+        }
+
+        if (offset + length == functionLabels[function]) {
+          for (const auto& var : functionVars[function]) {
+            result.push_back(spv::OpVariable | (4u << spv::WordCountShift));
+            result.push_back(var.first);
+            result.push_back(var.second);
+            result.push_back(spv::StorageClassFunction);
+          }
+        }
+
+        if (op == spv::OpFunctionEnd) {
+          inFunction = false;
+          function += 1;
+        }
+      }
+    }
+
+    code = SpirvCodeBuffer(result.size(), result.data());
+    return true;
+  }
+
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "spirv_pass.h"
+
+namespace dxvk {
+
+  /**
+   * \brief Private variable promotion pass
+   *
+   * Targets \c Private variables that are only accessed
+   * through whole-variable loads and stores from within a
+   * single function, such as DXBC temporary registers:
+   *
+   * - Within each basic block, loads are replaced by the
+   *   last value stored to or loaded from the variable,
+   *   and stores that get overwritten are removed.
+   * - Variables that are no longer read at all are
+   *   removed together with all remaining stores.
+   * - The remaining variables are moved into the
+   *   \c Function storage class, so that the driver's
+   *   own SSA construction can deal with values that
+   *   live across basic blocks.
+   *
+   * This pass does not insert phi instructions itself.
+   */
+  class SpirvPromotePrivateVarsPass : public SpirvPass {
+
+  public:
+
+    const char* name() const {
+      return "Promote private variables";
+    }
+
+    bool run(SpirvCodeBuffer& code);
+
+  };
+
+}
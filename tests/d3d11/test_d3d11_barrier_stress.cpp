@@ -0,0 +1,136 @@
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+#include <d3dcompiler.h>
+#include <d3d11.h>
+
+#include <windows.h>
+#include <windowsx.h>
+
+#include "../test_utils.h"
+
+using namespace dxvk;
+
+const std::string g_computeShaderCode =
+  "RWByteAddressBuffer buf_out : register(u0);\n"
+  "[numthreads(1,1,1)]\n"
+  "void main() {\n"
+  "  uint value = buf_out.Load(0);\n"
+  "  buf_out.Store(0, value + 1);\n"
+  "}\n";
+
+// Number of small UAV buffers that are cycled through
+// between flushes. This is meant to stress the barrier
+// set's bookkeeping rather than the GPU itself.
+const uint32_t g_bufferCount   = 512;
+const uint32_t g_dispatchCount = 64 * g_bufferCount;
+const uint32_t g_iterations    = 8;
+
+int WINAPI WinMain(HINSTANCE hInstance,
+                   HINSTANCE hPrevInstance,
+                   LPSTR lpCmdLine,
+                   int nCmdShow) {
+  Com<ID3D11Device>         device;
+  Com<ID3D11DeviceContext>  context;
+  Com<ID3D11ComputeShader>  computeShader;
+  Com<ID3D11Query>          query;
+
+  std::vector<Com<ID3D11Buffer>>              buffers(g_bufferCount);
+  std::vector<Com<ID3D11UnorderedAccessView>> views  (g_bufferCount);
+
+  if (FAILED(D3D11CreateDevice(
+        nullptr, D3D_DRIVER_TYPE_HARDWARE,
+        nullptr, 0, nullptr, 0, D3D11_SDK_VERSION,
+        &device, nullptr, &context))) {
+    std::cerr << "Failed to create D3D11 device" << std::endl;
+    return 1;
+  }
+
+  Com<ID3DBlob> computeShaderBlob;
+
+  if (FAILED(D3DCompile(
+        g_computeShaderCode.data(),
+        g_computeShaderCode.size(),
+        "Compute shader",
+        nullptr, nullptr,
+        "main", "cs_5_0", 0, 0,
+        &computeShaderBlob,
+        nullptr))) {
+    std::cerr << "Failed to compile compute shader" << std::endl;
+    return 1;
+  }
+
+  if (FAILED(device->CreateComputeShader(
+        computeShaderBlob->GetBufferPointer(),
+        computeShaderBlob->GetBufferSize(),
+        nullptr, &computeShader))) {
+    std::cerr << "Failed to create compute shader" << std::endl;
+    return 1;
+  }
+
+  D3D11_BUFFER_DESC bufferDesc;
+  bufferDesc.ByteWidth            = 256;
+  bufferDesc.Usage                = D3D11_USAGE_DEFAULT;
+  bufferDesc.BindFlags            = D3D11_BIND_UNORDERED_ACCESS;
+  bufferDesc.CPUAccessFlags       = 0;
+  bufferDesc.MiscFlags            = D3D11_RESOURCE_MISC_BUFFER_ALLOW_RAW_VIEWS;
+  bufferDesc.StructureByteStride  = 0;
+
+  D3D11_UNORDERED_ACCESS_VIEW_DESC viewDesc;
+  viewDesc.Format                 = DXGI_FORMAT_R32_TYPELESS;
+  viewDesc.ViewDimension          = D3D11_UAV_DIMENSION_BUFFER;
+  viewDesc.Buffer.FirstElement    = 0;
+  viewDesc.Buffer.NumElements     = bufferDesc.ByteWidth / sizeof(uint32_t);
+  viewDesc.Buffer.Flags           = D3D11_BUFFER_UAV_FLAG_RAW;
+
+  for (uint32_t i = 0; i < g_bufferCount; i++) {
+    if (FAILED(device->CreateBuffer(&bufferDesc, nullptr, &buffers[i]))) {
+      std::cerr << "Failed to create UAV buffer" << std::endl;
+      return 1;
+    }
+
+    if (FAILED(device->CreateUnorderedAccessView(buffers[i].ptr(), &viewDesc, &views[i]))) {
+      std::cerr << "Failed to create unordered access view" << std::endl;
+      return 1;
+    }
+  }
+
+  D3D11_QUERY_DESC queryDesc;
+  queryDesc.Query     = D3D11_QUERY_EVENT;
+  queryDesc.MiscFlags = 0;
+
+  if (FAILED(device->CreateQuery(&queryDesc, &query))) {
+    std::cerr << "Failed to create event query" << std::endl;
+    return 1;
+  }
+
+  context->CSSetShader(computeShader.ptr(), nullptr, 0);
+
+  for (uint32_t i = 0; i < g_iterations; i++) {
+    auto t0 = std::chrono::high_resolution_clock::now();
+
+    // Each dispatch writes a different buffer, so that the
+    // barrier set accumulates one entry per buffer before
+    // an actual hazard forces the barriers to be recorded.
+    for (uint32_t j = 0; j < g_dispatchCount; j++) {
+      context->CSSetUnorderedAccessViews(0, 1, &views[j % g_bufferCount], nullptr);
+      context->Dispatch(1, 1, 1);
+    }
+
+    context->End(query.ptr());
+
+    while (context->GetData(query.ptr(), nullptr, 0, 0) != S_OK)
+      continue;
+
+    auto t1 = std::chrono::high_resolution_clock::now();
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0);
+
+    std::cout << "Iteration " << i << ": "
+              << (double(us.count()) / double(g_dispatchCount))
+              << " us per dispatch" << std::endl;
+  }
+
+  context->ClearState();
+  return 0;
+}
@@ -0,0 +1,103 @@
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+#include <d3d11.h>
+
+#include <windows.h>
+#include <windowsx.h>
+
+#include "../test_utils.h"
+
+using namespace dxvk;
+
+// Texture sizes range from 16x16 (1 KiB) to 4096x4096
+// (64 MiB) pixels, so the amount of data grows by a
+// factor of four per step.
+const uint32_t g_minTextureSize = 16;
+const uint32_t g_maxTextureSize = 4096;
+
+// Number of uploads per texture size and row pitch
+const uint32_t g_iterations     = 16;
+
+int WINAPI WinMain(HINSTANCE hInstance,
+                   HINSTANCE hPrevInstance,
+                   LPSTR lpCmdLine,
+                   int nCmdShow) {
+  Com<ID3D11Device>         device;
+  Com<ID3D11DeviceContext>  context;
+  Com<ID3D11Query>          query;
+
+  if (FAILED(D3D11CreateDevice(
+        nullptr, D3D_DRIVER_TYPE_HARDWARE,
+        nullptr, 0, nullptr, 0, D3D11_SDK_VERSION,
+        &device, nullptr, &context))) {
+    std::cerr << "Failed to create D3D11 device" << std::endl;
+    return 1;
+  }
+
+  D3D11_QUERY_DESC queryDesc;
+  queryDesc.Query     = D3D11_QUERY_EVENT;
+  queryDesc.MiscFlags = 0;
+
+  if (FAILED(device->CreateQuery(&queryDesc, &query))) {
+    std::cerr << "Failed to create event query" << std::endl;
+    return 1;
+  }
+
+  for (uint32_t size = g_minTextureSize; size <= g_maxTextureSize; size *= 2) {
+    D3D11_TEXTURE2D_DESC textureDesc;
+    textureDesc.Width              = size;
+    textureDesc.Height             = size;
+    textureDesc.MipLevels          = 1;
+    textureDesc.ArraySize          = 1;
+    textureDesc.Format             = DXGI_FORMAT_R8G8B8A8_UNORM;
+    textureDesc.SampleDesc.Count   = 1;
+    textureDesc.SampleDesc.Quality = 0;
+    textureDesc.Usage              = D3D11_USAGE_DEFAULT;
+    textureDesc.BindFlags          = D3D11_BIND_SHADER_RESOURCE;
+    textureDesc.CPUAccessFlags     = 0;
+    textureDesc.MiscFlags          = 0;
+
+    Com<ID3D11Texture2D> texture;
+
+    if (FAILED(device->CreateTexture2D(&textureDesc, nullptr, &texture))) {
+      std::cerr << "Failed to create texture" << std::endl;
+      return 1;
+    }
+
+    // Test both tightly packed source data and source
+    // data with some padding at the end of each row
+    for (uint32_t padding = 0; padding <= 256; padding += 256) {
+      const uint32_t rowPitch = size * 4 + padding;
+
+      std::vector<char> data(size_t(rowPitch) * size);
+      std::memset(data.data(), 0x55, data.size());
+
+      auto t0 = std::chrono::high_resolution_clock::now();
+
+      for (uint32_t i = 0; i < g_iterations; i++) {
+        context->UpdateSubresource(texture.ptr(), 0,
+          nullptr, data.data(), rowPitch, 0);
+      }
+
+      context->End(query.ptr());
+
+      while (context->GetData(query.ptr(), nullptr, 0, 0) != S_OK)
+        continue;
+
+      auto t1 = std::chrono::high_resolution_clock::now();
+      auto us = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0);
+
+      double bytesTotal = double(size) * double(size) * 4.0 * double(g_iterations);
+
+      std::cout << size << "x" << size
+                << (padding ? " (padded): " : " (packed): ")
+                << (bytesTotal / double(us.count() ? us.count() : 1))
+                << " MB/s" << std::endl;
+    }
+  }
+
+  context->ClearState();
+  return 0;
+}
@@ -0,0 +1,519 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <unordered_map>
+
+#include "../../src/dxbc/dxbc_module.h"
+#include "../../src/dxvk/dxvk_shader.h"
+
+#include "../../src/util/thread.h"
+
+#include <shellapi.h>
+#include <windows.h>
+#include <windowsx.h>
+
+// Resolves GetProcessMemoryInfo to the kernel32
+// export so that we do not need to link psapi
+#define PSAPI_VERSION 2
+#include <psapi.h>
+
+namespace dxvk {
+  Logger Logger::s_instance("dxbc-compile-bench.log");
+}
+
+using namespace dxvk;
+
+// Per-shader timings below this threshold are
+// considered noise when comparing to a baseline
+const double g_minRegressionMs = 0.1;
+
+// Shaders are grouped by the size of their DXBC
+// code, so that the effect of optimizations on
+// large shaders does not get lost in the noise.
+const std::array<size_t, 4> g_bucketSizes = {{
+  4 << 10, 16 << 10, 64 << 10, ~size_t(0),
+}};
+
+struct ShaderResult {
+  std::string name;
+  size_t      dxbcSize  = 0;
+  size_t      spirvSize = 0;
+  double      ms        = 0.0;
+  bool        success   = false;
+};
+
+struct BucketStats {
+  uint32_t shaderCount = 0;
+  double   totalMs     = 0.0;
+  double   matchMs     = 0.0;
+  double   baseMs      = 0.0;
+};
+
+using ShaderResultMap = std::unordered_map<std::string, ShaderResult>;
+
+struct BenchOptions {
+  std::vector<std::wstring> paths;
+  DxbcOptions  compilerOptions;
+  std::string  outputFile;
+  std::string  baselineFile;
+  uint32_t     numThreads = 0;
+  uint32_t     iterations = 8;
+  double       tolerance  = 10.0;
+};
+
+
+void findShaders(
+  const std::wstring&               path,
+        std::vector<std::wstring>&  files) {
+  DWORD attributes = GetFileAttributesW(path.c_str());
+
+  if (attributes == INVALID_FILE_ATTRIBUTES) {
+    Logger::err(str::format("File not found: ", str::fromws(path.c_str())));
+    return;
+  }
+
+  if (!(attributes & FILE_ATTRIBUTE_DIRECTORY)) {
+    files.push_back(path);
+    return;
+  }
+
+  WIN32_FIND_DATAW findData;
+  HANDLE handle = FindFirstFileW((path + L"\\*.dxbc").c_str(), &findData);
+
+  if (handle == INVALID_HANDLE_VALUE)
+    return;
+
+  do {
+    if (!(findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+      files.push_back(path + L"\\" + findData.cFileName);
+  } while (FindNextFileW(handle, &findData));
+
+  FindClose(handle);
+}
+
+
+ShaderResult compileShader(
+  const std::wstring&   path,
+  const DxbcOptions&    options,
+        uint32_t        iterations) {
+  ShaderResult result;
+  result.name = str::fromws(path.c_str());
+
+  try {
+    std::ifstream ifile(result.name, std::ios::binary);
+    ifile.ignore(std::numeric_limits<std::streamsize>::max());
+    std::streamsize length = ifile.gcount();
+    ifile.clear();
+
+    ifile.seekg(0, std::ios_base::beg);
+    std::vector<char> dxbcCode(length);
+    ifile.read(dxbcCode.data(), length);
+
+    DxbcModuleInfo moduleInfo;
+    moduleInfo.options = options;
+    moduleInfo.tess = nullptr;
+    moduleInfo.xfb  = nullptr;
+
+    // Use the fastest run, which is the least
+    // affected by other threads and the OS
+    Rc<DxvkShader> shader;
+    double minMs = std::numeric_limits<double>::max();
+
+    for (uint32_t i = 0; i < iterations; i++) {
+      auto t0 = std::chrono::high_resolution_clock::now();
+
+      DxbcReader reader(dxbcCode.data(), dxbcCode.size());
+      DxbcModule module(reader);
+      shader = module.compile(moduleInfo, result.name);
+
+      auto t1 = std::chrono::high_resolution_clock::now();
+      auto us = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0);
+
+      minMs = std::min(minMs, double(us.count()) / 1000.0);
+    }
+
+    std::ostringstream spirvCode;
+    shader->dump(spirvCode);
+
+    result.dxbcSize  = size_t(length);
+    result.spirvSize = spirvCode.str().size() / sizeof(uint32_t);
+    result.ms        = minMs;
+    result.success   = true;
+  } catch (const DxvkError& e) {
+    Logger::err(str::format(result.name, ": ", e.message()));
+  }
+
+  return result;
+}
+
+
+size_t getPeakMemory() {
+  PROCESS_MEMORY_COUNTERS counters = { };
+  counters.cb = sizeof(counters);
+
+  if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    return 0;
+
+  return counters.PeakWorkingSetSize;
+}
+
+
+std::string escapeJsonString(const std::string& str) {
+  std::string result;
+
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      result += '\\';
+      result += c;
+    } else if (uint8_t(c) < 0x20) {
+      result += str::format("\\u00", "0123456789abcdef"[c >> 4], "0123456789abcdef"[c & 0xf]);
+    } else {
+      result += c;
+    }
+  }
+
+  return result;
+}
+
+
+void writeJson(
+        std::ostream&               stream,
+  const std::vector<ShaderResult>&  results,
+        double                      totalMs,
+        size_t                      peakMemory) {
+  // Each shader goes on its own line so that
+  // baseline files can be read back easily
+  stream << std::fixed << std::setprecision(3);
+  stream << "{" << std::endl;
+  stream << "  \"totalMs\": " << totalMs << "," << std::endl;
+  stream << "  \"peakMemory\": " << peakMemory << "," << std::endl;
+  stream << "  \"shaders\": [" << std::endl;
+
+  for (size_t i = 0; i < results.size(); i++) {
+    const ShaderResult& r = results[i];
+
+    stream << "    { \"name\": \"" << escapeJsonString(r.name) << "\""
+           << ", \"success\": " << (r.success ? "true" : "false")
+           << ", \"dxbcSize\": " << r.dxbcSize
+           << ", \"spirvWords\": " << r.spirvSize
+           << ", \"ms\": " << r.ms << " }"
+           << (i + 1 < results.size() ? "," : "") << std::endl;
+  }
+
+  stream << "  ]" << std::endl;
+  stream << "}" << std::endl;
+}
+
+
+std::string findJsonValue(
+  const std::string&  line,
+  const std::string&  key) {
+  size_t begin = line.find("\"" + key + "\": ");
+
+  if (begin == std::string::npos)
+    return std::string();
+
+  begin += key.size() + 4;
+  size_t end = line.find_first_of(",}", begin);
+  return line.substr(begin, end - begin);
+}
+
+
+bool readJsonString(
+  const std::string&  line,
+        size_t&       pos,
+        std::string&  str) {
+  if (pos >= line.size() || line[pos++] != '"')
+    return false;
+
+  str.clear();
+
+  while (pos < line.size()) {
+    char c = line[pos++];
+
+    if (c == '"')
+      return true;
+
+    if (c == '\\') {
+      if (pos >= line.size())
+        return false;
+      c = line[pos++];
+
+      // Control characters are written as \u00XX
+      if (c == 'u') {
+        if (pos + 4 > line.size())
+          return false;
+        c = char(std::strtoul(line.substr(pos, 4).c_str(), nullptr, 16));
+        pos += 4;
+      }
+    }
+
+    str += c;
+  }
+
+  return false;
+}
+
+
+bool readJson(
+  const std::string&      fileName,
+        ShaderResultMap&  results) {
+  std::ifstream ifile(fileName);
+
+  if (!ifile)
+    return false;
+
+  // This only understands the format written by writeJson.
+  // The name is parsed first since it may contain any of
+  // the characters that delimit the other values.
+  const std::string nameKey = "{ \"name\": ";
+  std::string line;
+
+  while (std::getline(ifile, line)) {
+    size_t pos = line.find(nameKey);
+
+    if (pos == std::string::npos)
+      continue;
+
+    ShaderResult r;
+    pos += nameKey.size();
+
+    if (!readJsonString(line, pos, r.name))
+      return false;
+
+    std::string values = line.substr(pos);
+    r.success   = findJsonValue(values, "success") == "true";
+    r.dxbcSize  = std::strtoull(findJsonValue(values, "dxbcSize").c_str(), nullptr, 10);
+    r.spirvSize = std::strtoull(findJsonValue(values, "spirvWords").c_str(), nullptr, 10);
+    r.ms        = std::strtod(findJsonValue(values, "ms").c_str(), nullptr);
+
+    results.insert({ r.name, r });
+  }
+
+  return true;
+}
+
+
+void printBuckets(
+  const std::vector<ShaderResult>&  results,
+  const ShaderResultMap&            baseline) {
+  std::array<BucketStats, g_bucketSizes.size()> buckets;
+
+  for (const auto& r : results) {
+    if (!r.success)
+      continue;
+
+    size_t bucket = 0;
+
+    while (r.dxbcSize > g_bucketSizes[bucket])
+      bucket += 1;
+
+    buckets[bucket].shaderCount += 1;
+    buckets[bucket].totalMs     += r.ms;
+
+    // Only shaders present in both runs count towards
+    // the speedup, so the shader sets need not match
+    auto b = baseline.find(r.name);
+
+    if (b != baseline.end() && b->second.success) {
+      buckets[bucket].matchMs += r.ms;
+      buckets[bucket].baseMs  += b->second.ms;
+    }
+  }
+
+  size_t lowerBound = 0;
+
+  for (size_t i = 0; i < buckets.size(); i++) {
+    const BucketStats& b = buckets[i];
+
+    if (b.shaderCount) {
+      std::cout << (lowerBound >> 10) << " kB";
+
+      if (g_bucketSizes[i] != ~size_t(0))
+        std::cout << " - " << (g_bucketSizes[i] >> 10) << " kB: ";
+      else
+        std::cout << " and above: ";
+
+      std::cout << b.shaderCount << " shaders, "
+                << (b.totalMs / double(b.shaderCount)) << " ms average";
+
+      if (b.baseMs > 0.0 && b.matchMs > 0.0)
+        std::cout << ", speedup " << (b.baseMs / b.matchMs) << "x";
+
+      std::cout << std::endl;
+    }
+
+    lowerBound = g_bucketSizes[i];
+  }
+}
+
+
+bool compareResults(
+  const std::vector<ShaderResult>&  results,
+  const ShaderResultMap&            baseline,
+  const BenchOptions&               options) {
+  double factor = 1.0 + options.tolerance / 100.0;
+  double baseMs = 0.0;
+  double currMs = 0.0;
+  bool   passed = true;
+
+  for (const auto& r : results) {
+    auto b = baseline.find(r.name);
+
+    if (b == baseline.end() || !b->second.success)
+      continue;
+
+    if (!r.success) {
+      std::cout << r.name << ": failed to compile, compiled in baseline" << std::endl;
+      passed = false;
+      continue;
+    }
+
+    baseMs += b->second.ms;
+    currMs += r.ms;
+
+    if (r.ms > b->second.ms * factor && r.ms - b->second.ms > g_minRegressionMs) {
+      std::cout << r.name << ": " << b->second.ms << " ms -> "
+                << r.ms << " ms" << std::endl;
+    }
+
+    if (r.spirvSize != b->second.spirvSize) {
+      std::cout << r.name << ": " << b->second.spirvSize << " -> "
+                << r.spirvSize << " SPIR-V words" << std::endl;
+    }
+  }
+
+  // Individual timings are too noisy to fail the run,
+  // so only the total time is checked against the limit
+  std::cout << "Baseline: " << baseMs << " ms, current: " << currMs << " ms" << std::endl;
+
+  if (currMs > baseMs * factor) {
+    std::cout << "Compile time regressed by more than "
+              << options.tolerance << "%" << std::endl;
+    passed = false;
+  }
+
+  return passed;
+}
+
+
+int WINAPI WinMain(HINSTANCE hInstance,
+                   HINSTANCE hPrevInstance,
+                   LPSTR lpCmdLine,
+                   int nCmdShow) {
+  int     argc = 0;
+  LPWSTR* argv = CommandLineToArgvW(
+    GetCommandLineW(), &argc);
+
+  BenchOptions options;
+  options.compilerOptions.useSubgroupOpsForEarlyDiscard = true;
+
+  for (int i = 1; i < argc; i++) {
+    std::wstring arg = argv[i];
+
+    if (i + 1 < argc && arg == L"-j")
+      options.numThreads = std::wcstoul(argv[++i], nullptr, 10);
+    else if (i + 1 < argc && arg == L"-n")
+      options.iterations = std::wcstoul(argv[++i], nullptr, 10);
+    else if (i + 1 < argc && arg == L"-o")
+      options.outputFile = str::fromws(argv[++i]);
+    else if (i + 1 < argc && arg == L"-b")
+      options.baselineFile = str::fromws(argv[++i]);
+    else if (i + 1 < argc && arg == L"-t")
+      options.tolerance = std::wcstod(argv[++i], nullptr);
+    else if (arg == L"-p")
+      options.compilerOptions.promoteTempRegisters = true;
+    else if (arg == L"-d")
+      options.compilerOptions.eliminateDeadCode = true;
+    else
+      options.paths.push_back(arg);
+  }
+
+  if (options.paths.empty()) {
+    Logger::err("Usage: dxbc-compile-bench [-j threads] [-n iterations] [-o output.json] [-b baseline.json] [-t tolerance%] [-p] [-d] directory|shader.dxbc ...");
+    return 1;
+  }
+
+  if (!options.numThreads)
+    options.numThreads = dxvk::thread::hardware_concurrency();
+
+  options.iterations = std::max(options.iterations, 1u);
+
+  ShaderResultMap baseline;
+
+  if (!options.baselineFile.empty() && !readJson(options.baselineFile, baseline)) {
+    Logger::err(str::format("Failed to read baseline ", options.baselineFile));
+    return 1;
+  }
+
+  std::vector<std::wstring> files;
+
+  for (const auto& path : options.paths)
+    findShaders(path, files);
+
+  if (files.empty()) {
+    Logger::err("No shaders found");
+    return 1;
+  }
+
+  // Sort by name so that the output is stable
+  std::sort(files.begin(), files.end());
+
+  // Compile all shaders, each thread picking
+  // up the next file that is not yet taken
+  std::vector<ShaderResult> results(files.size());
+  std::atomic<size_t>       nextFile = { 0 };
+
+  auto t0 = std::chrono::high_resolution_clock::now();
+
+  std::vector<dxvk::thread> threads;
+
+  for (uint32_t i = 0; i < std::min<size_t>(options.numThreads, files.size()); i++) {
+    threads.emplace_back([&] () {
+      size_t index;
+
+      while ((index = nextFile++) < files.size())
+        results[index] = compileShader(files[index], options.compilerOptions, options.iterations);
+    });
+  }
+
+  for (auto& thread : threads)
+    thread.join();
+
+  auto t1 = std::chrono::high_resolution_clock::now();
+  auto us = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0);
+
+  double totalMs = 0.0;
+  uint32_t numFailed = 0;
+
+  for (const auto& r : results) {
+    totalMs   += r.ms;
+    numFailed += r.success ? 0 : 1;
+  }
+
+  size_t peakMemory = getPeakMemory();
+
+  std::cout << results.size() << " shaders, " << numFailed << " failed, "
+            << totalMs << " ms compile time, "
+            << (double(us.count()) / 1000.0) << " ms wall time, "
+            << (peakMemory >> 20) << " MB peak memory" << std::endl;
+
+  printBuckets(results, baseline);
+
+  if (!options.outputFile.empty()) {
+    std::ofstream ofile(options.outputFile, std::ios::trunc);
+    writeJson(ofile, results, totalMs, peakMemory);
+  }
+
+  if (!options.baselineFile.empty() && !compareResults(results, baseline, options))
+    return 1;
+
+  return 0;
+}